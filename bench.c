@@ -0,0 +1,165 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Methods to time the processing of graphs and to report the results per
+ * order.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench.h"
+#include "lw_plane_graph.h"
+
+struct timespec timingStart;
+
+//latencies in nanoseconds for each order
+unsigned long long *latencies[MAXN + 1];
+int latencyCount[MAXN + 1];
+int latencyCapacity[MAXN + 1];
+unsigned long long searchNodesPerOrder[MAXN + 1];
+unsigned long long nanosecondsPerOrder[MAXN + 1];
+
+void startTiming(){
+    clock_gettime(CLOCK_MONOTONIC, &timingStart);
+}
+
+void stopTiming(int order, unsigned long long nodes){
+    struct timespec timingEnd;
+    clock_gettime(CLOCK_MONOTONIC, &timingEnd);
+    unsigned long long elapsed =
+            (timingEnd.tv_sec - timingStart.tv_sec)*1000000000ULL
+            + timingEnd.tv_nsec - timingStart.tv_nsec;
+
+    if(latencyCount[order] == latencyCapacity[order]){
+        latencyCapacity[order] = latencyCapacity[order] ? 2*latencyCapacity[order] : 256;
+        latencies[order] = (unsigned long long *)realloc(latencies[order],
+                sizeof(unsigned long long)*latencyCapacity[order]);
+        if(latencies[order] == NULL){
+            fprintf(stderr, "Insufficient memory for benchmark -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    latencies[order][latencyCount[order]++] = elapsed;
+    searchNodesPerOrder[order] += nodes;
+    nanosecondsPerOrder[order] += elapsed;
+}
+
+int compareLatencies(const void *a, const void *b){
+    unsigned long long l1 = *(const unsigned long long *)a;
+    unsigned long long l2 = *(const unsigned long long *)b;
+    return (l1 > l2) - (l1 < l2);
+}
+
+/**
+ * Returns the given percentile in microseconds. The latencies of the order
+ * need to be sorted.
+ */
+double percentile(int order, int p){
+    int index = (latencyCount[order] - 1)*p/100;
+    return latencies[order][index]/1000.0;
+}
+
+/**
+ * Looks up the record for this label and order in the baseline file.
+ * @return returns 1 if a record was found and 0 otherwise.
+ */
+int readBaselineRecord(char *baselineFile, char *label, int order,
+        double *secondsPerGraph, double *nodesPerGraph){
+    FILE *f = fopen(baselineFile, "r");
+    char recordLabel[256];
+    int recordOrder;
+    unsigned long long graphs, nodes;
+    double seconds, p50, p90, p99;
+    int found = 0;
+
+    if(f == NULL){
+        return 0;
+    }
+    while(fscanf(f, "%255s %d %llu %llu %lf %lf %lf %lf", recordLabel,
+            &recordOrder, &graphs, &nodes, &seconds, &p50, &p90, &p99) == 8){
+        if(recordOrder == order && graphs && strcmp(recordLabel, label) == 0){
+            *secondsPerGraph = seconds/graphs;
+            *nodesPerGraph = ((double)nodes)/graphs;
+            found = 1;
+        }
+    }
+    fclose(f);
+    return found;
+}
+
+void sortLatencies(){
+    int order;
+    for(order = 0; order <= MAXN; order++){
+        if(latencyCount[order]){
+            qsort(latencies[order], latencyCount[order],
+                    sizeof(unsigned long long), compareLatencies);
+        }
+    }
+}
+
+void writeBenchmarkReport(FILE *f, char *label, char *baselineFile){
+    int order;
+
+    sortLatencies();
+    fprintf(f, "Benchmark %s\n", label);
+    fprintf(f, " order   graphs     graphs/s  nodes/graph   p50(us)   p90(us)   p99(us)");
+    if(baselineFile != NULL){
+        fprintf(f, "   speedup   nodes");
+    }
+    fprintf(f, "\n");
+    for(order = 0; order <= MAXN; order++){
+        if(!latencyCount[order]){
+            continue;
+        }
+        double seconds = nanosecondsPerOrder[order]/1e9;
+        double nodesPerGraph = ((double)searchNodesPerOrder[order])/latencyCount[order];
+        fprintf(f, "%6d %8d %12.1f %12.1f %9.1f %9.1f %9.1f", order,
+                latencyCount[order],
+                seconds > 0 ? latencyCount[order]/seconds : 0.0,
+                nodesPerGraph,
+                percentile(order, 50), percentile(order, 90), percentile(order, 99));
+        if(baselineFile != NULL){
+            double baselineSeconds, baselineNodes;
+            if(readBaselineRecord(baselineFile, label, order,
+                    &baselineSeconds, &baselineNodes)){
+                //speedup > 1 means faster than the baseline
+                fprintf(f, " %8.2fx", seconds > 0 ?
+                        baselineSeconds*latencyCount[order]/seconds : 0.0);
+                if(nodesPerGraph > 0){
+                    fprintf(f, " %6.2fx", baselineNodes/nodesPerGraph);
+                } else {
+                    fprintf(f, "       -");
+                }
+            } else {
+                fprintf(f, "         -       -");
+            }
+        }
+        fprintf(f, "\n");
+    }
+}
+
+void appendBenchmarkRecords(char *file, char *label){
+    int order;
+    FILE *f = fopen(file, "a");
+
+    if(f == NULL){
+        fprintf(stderr, "Could not open %s -- exiting!\n", file);
+        exit(EXIT_FAILURE);
+    }
+    sortLatencies();
+    for(order = 0; order <= MAXN; order++){
+        if(latencyCount[order]){
+            fprintf(f, "%s %d %d %llu %.6f %.1f %.1f %.1f\n", label, order,
+                    latencyCount[order], searchNodesPerOrder[order],
+                    nanosecondsPerOrder[order]/1e9,
+                    percentile(order, 50), percentile(order, 90), percentile(order, 99));
+        }
+    }
+    fclose(f);
+}
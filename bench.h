@@ -0,0 +1,28 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Methods to time the processing of graphs and to report the results per
+ * order. Records have the form
+ *     label order graphs nodes seconds p50 p90 p99
+ * where the latency percentiles are given in microseconds.
+ */
+
+#include <stdio.h>
+
+#ifndef BENCH_H
+#define	BENCH_H
+
+void startTiming();
+
+void stopTiming(int order, unsigned long long nodes);
+
+void writeBenchmarkReport(FILE *f, char *label, char *baselineFile);
+
+void appendBenchmarkRecords(char *file, char *label);
+
+#endif	/* BENCH_H */
+
@@ -34,6 +34,9 @@ typedef unsigned long long int bitset;
 #define SAFE_REMOVE(s, el) ADD(s, el); REMOVE(s, el)
 #define SAFE_REMOVE_ALL(s, elements) ADD_ALL(s, elements); REMOVE_ALL(s, elements)
 
+//the smallest element of a non-empty set
+#define FIRST_ELEMENT(s) __builtin_ctzll(s)
+
 //the maximum capacity of a set
 #define SET_CAPACITY (sizeof(bitset)*8)
 
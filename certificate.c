@@ -0,0 +1,73 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Reading and writing certificates for hamiltonian-connectedness.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "certificate.h"
+
+#define CERTIFICATE_HEADER ">>hamconntri_certificate<<"
+
+void writeCertificateHeader(FILE *f){
+    fprintf(f, CERTIFICATE_HEADER);
+}
+
+void writeCertificate(FILE *f, WITNESSES paths, int pathCount, int order){
+    int i;
+    putc(pathCount & 0xFF, f);
+    putc(pathCount >> 8, f);
+    for(i = 0; i < pathCount; i++){
+        fwrite(paths[i], sizeof(unsigned char), order, f);
+    }
+}
+
+/**
+ * 
+ * @param f
+ * @return returns 1 if the header was read and 0 otherwise.
+ */
+int readCertificateHeader(FILE *f){
+    char header[sizeof(CERTIFICATE_HEADER)];
+    int length = strlen(CERTIFICATE_HEADER);
+    
+    if(fread(header, sizeof(char), length, f) != length){
+        return 0;
+    }
+    header[length] = 0;
+    return strcmp(header, CERTIFICATE_HEADER) == 0;
+}
+
+/**
+ * 
+ * @param f
+ * @param paths
+ * @param pathCount
+ * @param order
+ * @return returns 1 if a record was read and 0 otherwise.
+ */
+int readCertificate(FILE *f, WITNESSES paths, int *pathCount, int order){
+    int i;
+    int low = getc(f);
+    int high = getc(f);
+    
+    if(low == EOF || high == EOF){
+        return 0;
+    }
+    *pathCount = low | (high << 8);
+    if(*pathCount > MAXWITNESSES){
+        return 0;
+    }
+    for(i = 0; i < *pathCount; i++){
+        if(fread(paths[i], sizeof(unsigned char), order, f) != order){
+            return 0;
+        }
+    }
+    return 1;
+}
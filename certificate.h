@@ -0,0 +1,35 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Certificates for hamiltonian-connectedness. A certificate file starts with
+ * the header >>hamconntri_certificate<< and contains a record for each graph
+ * in the input: the number of witness paths (two bytes, little endian),
+ * followed by the vertices of each witness path (one byte per vertex). Graphs
+ * that are not hamiltonian-connected have no witness paths.
+ */
+
+#include <stdio.h>
+#include "lw_plane_graph.h"
+
+#ifndef CERTIFICATE_H
+#define	CERTIFICATE_H
+
+//there is at most one witness path per pair of vertices
+#define MAXWITNESSES (MAXN*(MAXN-1)/2)
+
+typedef unsigned char WITNESSES[MAXWITNESSES][MAXN];
+
+void writeCertificateHeader(FILE *f);
+
+void writeCertificate(FILE *f, WITNESSES paths, int pathCount, int order);
+
+int readCertificateHeader(FILE *f);
+
+int readCertificate(FILE *f, WITNESSES paths, int *pathCount, int order);
+
+#endif	/* CERTIFICATE_H */
+
@@ -0,0 +1,103 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Checkpoints for long runs.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "checkpoint.h"
+#include "lw_plane_graph.h"
+
+void writeCheckpoint(char *name, SUMMARY *checkpoint){
+    char temporaryName[4096];
+    snprintf(temporaryName, sizeof(temporaryName), "%s.tmp", name);
+
+    FILE *f = fopen(temporaryName, "w");
+    if(f == NULL){
+        fprintf(stderr, "Could not open %s -- exiting!\n", temporaryName);
+        exit(EXIT_FAILURE);
+    }
+    writeSummary(f, checkpoint);
+    syncStream(f);
+    if(fclose(f) || rename(temporaryName, name)){
+        fprintf(stderr, "Could not write checkpoint %s -- exiting!\n", name);
+        exit(EXIT_FAILURE);
+    }
+}
+
+boolean readCheckpoint(char *name, SUMMARY *checkpoint){
+    FILE *f = fopen(name, "r");
+    if(f == NULL){
+        return FALSE;
+    }
+    boolean success = readSummary(f, checkpoint);
+    fclose(f);
+    return success;
+}
+
+/**
+ *
+ * @return returns the current position in the stream, or 0 if the stream is
+ * not seekable.
+ */
+unsigned long long streamPosition(FILE *f){
+    off_t position = ftello(f);
+    return position < 0 ? 0ULL : (unsigned long long)position;
+}
+
+/**
+ * Makes sure that everything that was written to the stream is on disk before
+ * a checkpoint refers to it.
+ */
+void syncStream(FILE *f){
+    fflush(f);
+    //fails for pipes and terminals, which cannot be resumed anyway
+    fsync(fileno(f));
+}
+
+/**
+ * Discards everything that was written to the stream after the given length,
+ * and continues writing from there.
+ */
+void truncateStream(FILE *f, off_t length){
+    fflush(f);
+    if(ftruncate(fileno(f), length) || fseeko(f, length, SEEK_SET)){
+        fprintf(stderr, "Could not truncate output to the checkpoint -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * Skips the given number of graphs in the input. If the offset of the graph
+ * after them is known and the input is seekable, we seek to that offset. The
+ * first graph is always read, so the header has been handled.
+ */
+void skipGraphs(FILE *input, unsigned long long graphs, off_t offset){
+    unsigned short code[MAXCODELENGTH];
+    int length;
+    unsigned long long i;
+
+    if(graphs == 0ULL){
+        return;
+    }
+    if(!readPlanarCode(code, &length, input)){
+        fprintf(stderr, "Input ends before the checkpoint -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    if(offset && fseeko(input, offset, SEEK_SET) == 0){
+        return;
+    }
+    for(i = 1; i < graphs; i++){
+        if(!readPlanarCode(code, &length, input)){
+            fprintf(stderr, "Input ends before the checkpoint -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
@@ -0,0 +1,36 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Checkpoints for long runs. A checkpoint is a summary that contains the
+ * number of graphs that were read, the offset in the input (0 if the input
+ * is not seekable), the lengths of the output files and the counters of the
+ * run. The checkpoint is first written to a temporary file, which is then
+ * renamed, so an interrupted run always leaves a complete checkpoint.
+ */
+
+#include <stdio.h>
+#include <sys/types.h>
+#include "summary.h"
+#include "boolean.h"
+
+#ifndef CHECKPOINT_H
+#define	CHECKPOINT_H
+
+void writeCheckpoint(char *name, SUMMARY *checkpoint);
+
+boolean readCheckpoint(char *name, SUMMARY *checkpoint);
+
+unsigned long long streamPosition(FILE *f);
+
+void syncStream(FILE *f);
+
+void truncateStream(FILE *f, off_t length);
+
+void skipGraphs(FILE *input, unsigned long long graphs, off_t offset);
+
+#endif	/* CHECKPOINT_H */
+
@@ -0,0 +1,432 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Transparent reading and writing of compressed planar_code. The compressed
+ * streams are wrapped in a FILE with fopencookie. Zstandard support is only
+ * available if HAVE_ZSTD is defined.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "compression.h"
+#include "boolean.h"
+
+#define BLOCKSIZE (1 << 16)
+#define BLOCKCOUNT 8
+#define CHUNKSIZE (1 << 16)
+
+#define GZIP_MAGIC 0x1F
+#define ZSTD_MAGIC 0x28
+
+int parseCompression(char *name){
+    if(strcmp(name, "gzip") == 0){
+        return GZIP_COMPRESSION;
+    } else if(strcmp(name, "zstd") == 0){
+#ifdef HAVE_ZSTD
+        return ZSTD_COMPRESSION;
+#else
+        fprintf(stderr, "No support for zstd was compiled in.\n");
+        return -1;
+#endif
+    } else if(strcmp(name, "none") == 0){
+        return NO_COMPRESSION;
+    }
+    fprintf(stderr, "Unknown compression %s.\n", name);
+    return -1;
+}
+
+//====================== DECOMPRESSION =======================
+
+/* The decompression thread fills the block at head, the reader empties the
+ * block at tail. The filled blocks lie between tail and head.
+ */
+typedef struct {
+    FILE *file;
+    int compression;
+
+    unsigned char blocks[BLOCKCOUNT][BLOCKSIZE];
+    size_t blockLength[BLOCKCOUNT];
+    int head, tail, filled;
+    size_t readPosition;
+    boolean finished;
+    boolean closed;
+
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    pthread_t thread;
+} DECOMPRESSOR;
+
+/**
+ * Waits for a free block.
+ *
+ * @return returns the block, or NULL if the reader closed the stream.
+ */
+unsigned char *acquireBlock(DECOMPRESSOR *d){
+    unsigned char *block;
+    pthread_mutex_lock(&d->lock);
+    while(d->filled == BLOCKCOUNT && !d->closed){
+        pthread_cond_wait(&d->notFull, &d->lock);
+    }
+    block = d->closed ? NULL : d->blocks[d->head];
+    pthread_mutex_unlock(&d->lock);
+    return block;
+}
+
+void releaseBlock(DECOMPRESSOR *d, size_t length){
+    pthread_mutex_lock(&d->lock);
+    d->blockLength[d->head] = length;
+    d->head = (d->head + 1) % BLOCKCOUNT;
+    d->filled++;
+    pthread_cond_signal(&d->notEmpty);
+    pthread_mutex_unlock(&d->lock);
+}
+
+void decompressGzip(DECOMPRESSOR *d){
+    unsigned char in[CHUNKSIZE];
+    z_stream stream;
+    int result = Z_OK;
+
+    memset(&stream, 0, sizeof(stream));
+    //32 enables the detection of the gzip header
+    if(inflateInit2(&stream, 15 + 32) != Z_OK){
+        fprintf(stderr, "Could not initialise gzip decompression -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    unsigned char *block = acquireBlock(d);
+    stream.next_out = block;
+    stream.avail_out = BLOCKSIZE;
+    while(block != NULL){
+        if(!stream.avail_in){
+            stream.avail_in = fread(in, 1, CHUNKSIZE, d->file);
+            stream.next_in = in;
+            if(!stream.avail_in){
+                if(result != Z_STREAM_END){
+                    fprintf(stderr, "Unexpected end of gzip input -- exiting!\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+        }
+        if(result == Z_STREAM_END){
+            //concatenated gzip members
+            inflateReset(&stream);
+        }
+        result = inflate(&stream, Z_NO_FLUSH);
+        if(result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR){
+            fprintf(stderr, "Corrupt gzip input -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+        if(!stream.avail_out){
+            releaseBlock(d, BLOCKSIZE);
+            block = acquireBlock(d);
+            stream.next_out = block;
+            stream.avail_out = BLOCKSIZE;
+        }
+    }
+    if(block != NULL && stream.avail_out < BLOCKSIZE){
+        releaseBlock(d, BLOCKSIZE - stream.avail_out);
+    }
+    inflateEnd(&stream);
+}
+
+#ifdef HAVE_ZSTD
+void decompressZstd(DECOMPRESSOR *d){
+    unsigned char in[CHUNKSIZE];
+    ZSTD_inBuffer input = {in, 0, 0};
+    size_t result = 0;
+
+    ZSTD_DStream *stream = ZSTD_createDStream();
+    if(stream == NULL || ZSTD_isError(ZSTD_initDStream(stream))){
+        fprintf(stderr, "Could not initialise zstd decompression -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    unsigned char *block = acquireBlock(d);
+    ZSTD_outBuffer output = {block, BLOCKSIZE, 0};
+    while(block != NULL){
+        if(input.pos == input.size){
+            input.size = fread(in, 1, CHUNKSIZE, d->file);
+            input.pos = 0;
+            if(!input.size){
+                //result is 0 at the end of a frame
+                if(result){
+                    fprintf(stderr, "Unexpected end of zstd input -- exiting!\n");
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+        }
+        result = ZSTD_decompressStream(stream, &output, &input);
+        if(ZSTD_isError(result)){
+            fprintf(stderr, "Corrupt zstd input: %s -- exiting!\n", ZSTD_getErrorName(result));
+            exit(EXIT_FAILURE);
+        }
+        if(output.pos == output.size){
+            releaseBlock(d, BLOCKSIZE);
+            block = acquireBlock(d);
+            output.dst = block;
+            output.pos = 0;
+        }
+    }
+    if(block != NULL && output.pos){
+        releaseBlock(d, output.pos);
+    }
+    ZSTD_freeDStream(stream);
+}
+#endif
+
+void *decompress(void *cookie){
+    DECOMPRESSOR *d = (DECOMPRESSOR *)cookie;
+
+#ifdef HAVE_ZSTD
+    if(d->compression == ZSTD_COMPRESSION){
+        decompressZstd(d);
+    } else {
+        decompressGzip(d);
+    }
+#else
+    decompressGzip(d);
+#endif
+
+    pthread_mutex_lock(&d->lock);
+    d->finished = TRUE;
+    pthread_cond_signal(&d->notEmpty);
+    pthread_mutex_unlock(&d->lock);
+    return NULL;
+}
+
+ssize_t readDecompressed(void *cookie, char *buffer, size_t size){
+    DECOMPRESSOR *d = (DECOMPRESSOR *)cookie;
+    size_t copied = 0;
+
+    while(copied < size){
+        pthread_mutex_lock(&d->lock);
+        while(!d->filled && !d->finished){
+            pthread_cond_wait(&d->notEmpty, &d->lock);
+        }
+        boolean empty = !d->filled;
+        pthread_mutex_unlock(&d->lock);
+        if(empty){
+            break;
+        }
+
+        //the block at tail belongs to the reader while it is filled
+        size_t available = d->blockLength[d->tail] - d->readPosition;
+        size_t count = available < size - copied ? available : size - copied;
+        memcpy(buffer + copied, d->blocks[d->tail] + d->readPosition, count);
+        copied += count;
+        d->readPosition += count;
+
+        if(d->readPosition == d->blockLength[d->tail]){
+            pthread_mutex_lock(&d->lock);
+            d->tail = (d->tail + 1) % BLOCKCOUNT;
+            d->filled--;
+            d->readPosition = 0;
+            pthread_cond_signal(&d->notFull);
+            pthread_mutex_unlock(&d->lock);
+        }
+    }
+
+    return copied;
+}
+
+int closeDecompressed(void *cookie){
+    DECOMPRESSOR *d = (DECOMPRESSOR *)cookie;
+
+    pthread_mutex_lock(&d->lock);
+    d->closed = TRUE;
+    pthread_cond_signal(&d->notFull);
+    pthread_mutex_unlock(&d->lock);
+    pthread_join(d->thread, NULL);
+
+    fclose(d->file);
+    pthread_mutex_destroy(&d->lock);
+    pthread_cond_destroy(&d->notEmpty);
+    pthread_cond_destroy(&d->notFull);
+    free(d);
+    return 0;
+}
+
+/**
+ * Returns a stream with the decompressed contents of file if it starts with
+ * the magic bytes of gzip or zstd, and file itself otherwise. Closing the
+ * stream also closes file.
+ */
+FILE *openInputStream(FILE *file){
+    int c = getc(file);
+    if(c == EOF){
+        return file;
+    }
+    ungetc(c, file);
+
+    int compression;
+    if(c == GZIP_MAGIC){
+        compression = GZIP_COMPRESSION;
+    } else if(c == ZSTD_MAGIC){
+#ifdef HAVE_ZSTD
+        compression = ZSTD_COMPRESSION;
+#else
+        fprintf(stderr, "Input is compressed with zstd, but no support for zstd was compiled in -- exiting!\n");
+        exit(EXIT_FAILURE);
+#endif
+    } else {
+        //planar_code starts with a header, so this is uncompressed
+        return file;
+    }
+
+    DECOMPRESSOR *d = (DECOMPRESSOR *)calloc(1, sizeof(DECOMPRESSOR));
+    if(d == NULL){
+        fprintf(stderr, "Insufficient memory for decompression -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    d->file = file;
+    d->compression = compression;
+    pthread_mutex_init(&d->lock, NULL);
+    pthread_cond_init(&d->notEmpty, NULL);
+    pthread_cond_init(&d->notFull, NULL);
+    if(pthread_create(&d->thread, NULL, decompress, d)){
+        fprintf(stderr, "Could not start decompression thread -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    cookie_io_functions_t functions = {readDecompressed, NULL, NULL, closeDecompressed};
+    return fopencookie(d, "r", functions);
+}
+
+//====================== COMPRESSION =======================
+
+typedef struct {
+    FILE *file;
+    int compression;
+    z_stream gzipStream;
+#ifdef HAVE_ZSTD
+    ZSTD_CStream *zstdStream;
+#endif
+    unsigned char out[CHUNKSIZE];
+} COMPRESSOR;
+
+void writeGzip(COMPRESSOR *c, int flush){
+    int result;
+    do {
+        c->gzipStream.next_out = c->out;
+        c->gzipStream.avail_out = CHUNKSIZE;
+        result = deflate(&c->gzipStream, flush);
+        if(result == Z_STREAM_ERROR){
+            fprintf(stderr, "Error during gzip compression -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+        fwrite(c->out, 1, CHUNKSIZE - c->gzipStream.avail_out, c->file);
+    } while(!c->gzipStream.avail_out);
+}
+
+ssize_t writeCompressed(void *cookie, const char *buffer, size_t size){
+    COMPRESSOR *c = (COMPRESSOR *)cookie;
+
+#ifdef HAVE_ZSTD
+    if(c->compression == ZSTD_COMPRESSION){
+        ZSTD_inBuffer input = {buffer, size, 0};
+        while(input.pos < input.size){
+            ZSTD_outBuffer output = {c->out, CHUNKSIZE, 0};
+            size_t result = ZSTD_compressStream(c->zstdStream, &output, &input);
+            if(ZSTD_isError(result)){
+                fprintf(stderr, "Error during zstd compression: %s -- exiting!\n",
+                        ZSTD_getErrorName(result));
+                exit(EXIT_FAILURE);
+            }
+            fwrite(c->out, 1, output.pos, c->file);
+        }
+        return size;
+    }
+#endif
+
+    c->gzipStream.next_in = (unsigned char *)buffer;
+    c->gzipStream.avail_in = size;
+    writeGzip(c, Z_NO_FLUSH);
+    return size;
+}
+
+int closeCompressed(void *cookie){
+    COMPRESSOR *c = (COMPRESSOR *)cookie;
+
+#ifdef HAVE_ZSTD
+    if(c->compression == ZSTD_COMPRESSION){
+        size_t remaining;
+        do {
+            ZSTD_outBuffer output = {c->out, CHUNKSIZE, 0};
+            remaining = ZSTD_endStream(c->zstdStream, &output);
+            if(ZSTD_isError(remaining)){
+                fprintf(stderr, "Error during zstd compression -- exiting!\n");
+                exit(EXIT_FAILURE);
+            }
+            fwrite(c->out, 1, output.pos, c->file);
+        } while(remaining);
+        ZSTD_freeCStream(c->zstdStream);
+    } else {
+        c->gzipStream.avail_in = 0;
+        writeGzip(c, Z_FINISH);
+        deflateEnd(&c->gzipStream);
+    }
+#else
+    c->gzipStream.avail_in = 0;
+    writeGzip(c, Z_FINISH);
+    deflateEnd(&c->gzipStream);
+#endif
+
+    //the underlying file is not closed
+    int result = fflush(c->file);
+    free(c);
+    return result;
+}
+
+/**
+ * Returns a stream that writes the compressed data to file, or file itself
+ * if no compression is requested. Closing the stream does not close file.
+ */
+FILE *openOutputStream(FILE *file, int compression){
+    if(compression == NO_COMPRESSION){
+        return file;
+    }
+
+    COMPRESSOR *c = (COMPRESSOR *)calloc(1, sizeof(COMPRESSOR));
+    if(c == NULL){
+        fprintf(stderr, "Insufficient memory for compression -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    c->file = file;
+    c->compression = compression;
+
+#ifdef HAVE_ZSTD
+    if(compression == ZSTD_COMPRESSION){
+        c->zstdStream = ZSTD_createCStream();
+        if(c->zstdStream == NULL || ZSTD_isError(ZSTD_initCStream(c->zstdStream, 3))){
+            fprintf(stderr, "Could not initialise zstd compression -- exiting!\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+#endif
+    //16 selects the gzip format
+    if(compression == GZIP_COMPRESSION &&
+            deflateInit2(&c->gzipStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK){
+        fprintf(stderr, "Could not initialise gzip compression -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    cookie_io_functions_t functions = {NULL, writeCompressed, NULL, closeCompressed};
+    return fopencookie(c, "w", functions);
+}
@@ -0,0 +1,30 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Transparent reading and writing of compressed planar_code. Compressed
+ * input is recognised by its magic bytes and is decompressed on a separate
+ * thread into a ring buffer of blocks. The returned streams can be used with
+ * readPlanarCode and writeCode.
+ */
+
+#include <stdio.h>
+
+#ifndef COMPRESSION_H
+#define	COMPRESSION_H
+
+#define NO_COMPRESSION 0
+#define GZIP_COMPRESSION 1
+#define ZSTD_COMPRESSION 2
+
+int parseCompression(char *name);
+
+FILE *openInputStream(FILE *file);
+
+FILE *openOutputStream(FILE *file, int compression);
+
+#endif	/* COMPRESSION_H */
+
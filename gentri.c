@@ -0,0 +1,350 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Generates seeded random plane triangulations in planar_code. This is used
+ * to build reproducible corpora for the benchmarks.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include "bitset.h"
+#include "lw_plane_graph.h"
+#include "boolean.h"
+
+#define RANDOM_TRIANGULATION 0
+#define STACKED_TRIANGULATION 1
+#define FOUR_CONNECTED_TRIANGULATION 2
+#define KLEETOPE 3
+
+//the rotation around each vertex: the faces are (v, rotation[v][i], rotation[v][i+1])
+int rotation[MAXN + 1][MAXN];
+int degree[MAXN + 1];
+int order;
+
+unsigned long long randomState;
+
+unsigned long long nextRandom(){
+    //xorshift64*: the same seed gives the same corpus on every platform
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+    return randomState * 2685821657736338717ULL;
+}
+
+int randomInt(int bound){
+    return (int)(nextRandom() % bound);
+}
+
+int positionInRotation(int v, int w){
+    int i;
+    for(i = 0; i < degree[v]; i++){
+        if(rotation[v][i] == w){
+            return i;
+        }
+    }
+    fprintf(stderr, "%d is not a neighbour of %d -- exiting!\n", w, v);
+    exit(EXIT_FAILURE);
+}
+
+boolean areAdjacent(int v, int w){
+    int i;
+    for(i = 0; i < degree[v]; i++){
+        if(rotation[v][i] == w){
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+void insertAfter(int v, int after, int w){
+    int i;
+    int pos = positionInRotation(v, after);
+    for(i = degree[v]; i > pos + 1; i--){
+        rotation[v][i] = rotation[v][i-1];
+    }
+    rotation[v][pos + 1] = w;
+    degree[v]++;
+}
+
+void removeFromRotation(int v, int w){
+    int i;
+    for(i = positionInRotation(v, w); i < degree[v] - 1; i++){
+        rotation[v][i] = rotation[v][i+1];
+    }
+    degree[v]--;
+}
+
+void startK4(){
+    order = 4;
+    degree[1] = degree[2] = degree[3] = degree[4] = 3;
+    rotation[1][0] = 2; rotation[1][1] = 3; rotation[1][2] = 4;
+    rotation[2][0] = 1; rotation[2][1] = 4; rotation[2][2] = 3;
+    rotation[3][0] = 1; rotation[3][1] = 2; rotation[3][2] = 4;
+    rotation[4][0] = 1; rotation[4][1] = 3; rotation[4][2] = 2;
+}
+
+/* The double wheel: a cycle 3, ..., n and two poles 1 and 2. This is
+ * 4-connected for n at least 6.
+ */
+void startDoubleWheel(int n){
+    int i, rim = n - 2;
+    order = n;
+    degree[1] = degree[2] = rim;
+    for(i = 0; i < rim; i++){
+        int v = i + 3;
+        int next = (i + 1) % rim + 3;
+        int previous = (i + rim - 1) % rim + 3;
+        rotation[1][i] = v;
+        rotation[2][rim - 1 - i] = v;
+        degree[v] = 4;
+        rotation[v][0] = 1;
+        rotation[v][1] = previous;
+        rotation[v][2] = 2;
+        rotation[v][3] = next;
+    }
+}
+
+/* Inserts a new vertex in the face (v, a, b), where b follows a in the
+ * rotation of v.
+ */
+void insertVertexInFace(int v, int a, int b){
+    int x = ++order;
+    insertAfter(v, a, x);
+    insertAfter(a, b, x);
+    insertAfter(b, v, x);
+    degree[x] = 3;
+    rotation[x][0] = v;
+    rotation[x][1] = a;
+    rotation[x][2] = b;
+}
+
+void insertVertexInRandomFace(){
+    int v = randomInt(order) + 1;
+    int i = randomInt(degree[v]);
+    insertVertexInFace(v, rotation[v][i], rotation[v][(i + 1) % degree[v]]);
+}
+
+/* Tries to flip a random edge. If fourConnected is TRUE, flips that would
+ * introduce a separating triangle are rejected.
+ */
+boolean flipRandomEdge(boolean fourConnected){
+    int i;
+    int a = randomInt(order) + 1;
+    int pos = randomInt(degree[a]);
+    int b = rotation[a][pos];
+    int c = rotation[a][(pos + 1) % degree[a]];
+    int d = rotation[a][(pos + degree[a] - 1) % degree[a]];
+
+    if(degree[a] <= 3 || degree[b] <= 3 || areAdjacent(c, d)){
+        return FALSE;
+    }
+    if(fourConnected){
+        //the only common neighbours of c and d may be a and b
+        for(i = 0; i < degree[c]; i++){
+            int z = rotation[c][i];
+            if(z != a && z != b && areAdjacent(d, z)){
+                return FALSE;
+            }
+        }
+    }
+
+    removeFromRotation(a, b);
+    removeFromRotation(b, a);
+    insertAfter(c, a, d);
+    insertAfter(d, b, c);
+    return TRUE;
+}
+
+void randomiseByFlips(int flips, boolean fourConnected){
+    int i;
+    for(i = 0; i < flips; i++){
+        flipRandomEdge(fourConnected);
+    }
+}
+
+/* Inserts a vertex in each face of the current triangulation.
+ */
+void makeKleetope(){
+    int v, i;
+    int faces[2*MAXN][3];
+    int faceCount = 0;
+
+    for(v = 1; v <= order; v++){
+        for(i = 0; i < degree[v]; i++){
+            int a = rotation[v][i];
+            int b = rotation[v][(i + 1) % degree[v]];
+            if(v < a && v < b){
+                faces[faceCount][0] = v;
+                faces[faceCount][1] = a;
+                faces[faceCount][2] = b;
+                faceCount++;
+            }
+        }
+    }
+
+    for(i = 0; i < faceCount; i++){
+        insertVertexInFace(faces[i][0], faces[i][1], faces[i][2]);
+    }
+}
+
+void generateTriangulation(int type, int n){
+    if(type == FOUR_CONNECTED_TRIANGULATION){
+        startDoubleWheel(n);
+        randomiseByFlips(10*n, TRUE);
+    } else if(type == KLEETOPE){
+        //a kleetope of a triangulation on k vertices has 3k-4 vertices
+        int baseOrder = (n + 4)/3;
+        startK4();
+        while(order < baseOrder){
+            insertVertexInRandomFace();
+        }
+        randomiseByFlips(10*baseOrder, FALSE);
+        makeKleetope();
+        //every face contains a new vertex, so stacking keeps the large
+        //independent set of the kleetope
+        while(order < n){
+            insertVertexInRandomFace();
+        }
+    } else {
+        startK4();
+        while(order < n){
+            insertVertexInRandomFace();
+        }
+        if(type == RANDOM_TRIANGULATION){
+            randomiseByFlips(10*n, FALSE);
+        }
+    }
+}
+
+void writeTriangulation(FILE *f){
+    unsigned short code[MAXCODELENGTH];
+    int v, i, length = 0;
+
+    code[length++] = order;
+    for(v = 1; v <= order; v++){
+        for(i = 0; i < degree[v]; i++){
+            code[length++] = rotation[v][i];
+        }
+        code[length++] = 0;
+    }
+    writeCode(f, code, length);
+}
+
+//====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "The program %s generates random plane triangulations in planar_code.\n\n", name);
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options]\n\n", name);
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -t, --type type\n");
+    fprintf(stderr, "       The type of triangulations: random (random flips from a stacked\n");
+    fprintf(stderr, "       triangulation), stacked, fourconnected or kleetope. Default is random.\n");
+    fprintf(stderr, "    -n, --order n[:m]\n");
+    fprintf(stderr, "       Generate triangulations on n vertices, or on n up to m vertices.\n");
+    fprintf(stderr, "    -c, --count c\n");
+    fprintf(stderr, "       Generate c triangulations for each order. Default is 100.\n");
+    fprintf(stderr, "    -s, --seed s\n");
+    fprintf(stderr, "       Seed for the random generator. Default is 1.\n");
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options]\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+int main(int argc, char *argv[]) {
+
+    /*=========== commandline parsing ===========*/
+    int type = RANDOM_TRIANGULATION;
+    int minOrder = -1, maxOrder = -1;
+    int count = 100;
+    unsigned long long seed = 1ULL;
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"type", required_argument, NULL, 't'},
+        {"order", required_argument, NULL, 'n'},
+        {"count", required_argument, NULL, 'c'},
+        {"seed", required_argument, NULL, 's'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "ht:n:c:s:", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 't':
+                if(strcmp(optarg, "random") == 0){
+                    type = RANDOM_TRIANGULATION;
+                } else if(strcmp(optarg, "stacked") == 0){
+                    type = STACKED_TRIANGULATION;
+                } else if(strcmp(optarg, "fourconnected") == 0){
+                    type = FOUR_CONNECTED_TRIANGULATION;
+                } else if(strcmp(optarg, "kleetope") == 0){
+                    type = KLEETOPE;
+                } else {
+                    fprintf(stderr, "Unknown type %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'n':
+                if(sscanf(optarg, "%d:%d", &minOrder, &maxOrder) == 1){
+                    maxOrder = minOrder;
+                }
+                break;
+            case 'c':
+                count = atoi(optarg);
+                break;
+            case 's':
+                seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    int smallestOrder = 4;
+    if(type == FOUR_CONNECTED_TRIANGULATION){
+        smallestOrder = 6;
+    } else if(type == KLEETOPE){
+        smallestOrder = 8;
+    }
+    if(minOrder < smallestOrder || maxOrder < minOrder || maxOrder > MAXN){
+        fprintf(stderr, "Orders should be between %d and %lu.\n", smallestOrder, MAXN);
+        usage(name);
+        return EXIT_FAILURE;
+    }
+
+    /*=========== generate graphs ===========*/
+    //zero is a fixed point of xorshift
+    randomState = seed ? seed : 0x9E3779B97F4A7C15ULL;
+
+    int n, i;
+    writePlanarCodeHeader(stdout);
+    for(n = minOrder; n <= maxOrder; n++){
+        for(i = 0; i < count; i++){
+            generateTriangulation(type, n);
+            writeTriangulation(stdout);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -8,10 +8,19 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <getopt.h>
+#include <time.h>
 #include "bitset.h"
 #include "lw_plane_graph.h"
 #include "boolean.h"
+#include "bench.h"
+#include "prefilter.h"
+#include "summary.h"
+#include "compression.h"
+#include "certificate.h"
+#include "checkpoint.h"
+#include "oracle.h"
 
 bitset currentPath;
 int pathSequence[MAXN];
@@ -19,6 +28,30 @@ int pathPosition[MAXN+1];
 int pathLength;
 bitset connected[MAXN+1];
 
+//the number of calls to continuePath, used for benchmarking
+unsigned long long searchNodes = 0ULL;
+
+#define RECURSIVE_ENGINE 0
+#define ITERATIVE_ENGINE 1
+#define SPECIALISED_ENGINE 2
+#define EDGE_ENGINE 3
+
+//the search kernel that is used by startSearch
+int searchEngine = RECURSIVE_ENGINE;
+
+//a pair of vertices that is not connected by a hamiltonian path
+int failingStart, failingEnd;
+
+//all pairs that are not connected by a hamiltonian path, if requested
+boolean collectFailingPairs = FALSE;
+int failingPairs[MAXN*(MAXN-1)/2][2];
+int failingPairCount;
+
+//the hamiltonian paths that were found for the current graph
+boolean storeWitnesses = FALSE;
+WITNESSES witnesses;
+int witnessCount;
+
 void derivePathDepth1_fromStart(GRAPH graph, ADJACENCY adj, bitset *neighbours,
         int xi, int xi1, int end){
     int i;
@@ -39,7 +72,8 @@ void derivePathDepth1_fromStart(GRAPH graph, ADJACENCY adj, bitset *neighbours,
         int yi = graph[end][i];
         if(yi!=pathSequence[0]){
             //the other case is already handled by ham cycle
-            int direction = (pathPosition[yi] < xi1Pos) ? -1 : 1;
+            //for yi = x_{i-1} (the new start) the successor is x_{i-2}
+            int direction = (pathPosition[yi] <= xi1Pos) ? -1 : 1;
             int yi1 = pathSequence[pathPosition[yi]+direction];
             ADD(connected[yi1], xi1);
             ADD(connected[xi1], yi1);
@@ -83,6 +117,13 @@ void foundPath(GRAPH graph, ADJACENCY adj, bitset *neighbours){
     int start = pathSequence[0];
     int end = pathSequence[pathLength-1];
     
+    if(storeWitnesses){
+        for(i = 0; i < pathLength; i++){
+            witnesses[witnessCount][i] = pathSequence[i];
+        }
+        witnessCount++;
+    }
+    
     //start and end are connected by a hamiltonian path
     ADD(connected[start], end);
     ADD(connected[end], start);
@@ -125,19 +166,204 @@ void foundPath(GRAPH graph, ADJACENCY adj, bitset *neighbours){
     }
 }
 
+//================= REDUCTION OF DEGREE 3 VERTICES ==================
+
+/* A vertex x of degree 3 lies inside a facial triangle of G-x. A hamiltonian
+ * path passes through x via two of its neighbours, so replacing them by the
+ * edge between these neighbours gives a hamiltonian path in G-x. Conversely
+ * each hamiltonian path in G-x that uses an edge of that triangle can be
+ * lifted to G. If x is an endpoint, then the path continues in one of the
+ * neighbours of x.
+ * 
+ * We remove an independent set X of degree 3 vertices and search for paths
+ * in the reduced graph H = G-X. A path in H can be lifted if each vertex of
+ * X that is not an endpoint can be assigned to a distinct path edge of its
+ * triangle. Lifted paths are handled by foundPath in the original graph.
+ */
+
+bitset reducedVertices = EMPTY_SET;
+GRAPH reducedGraph;
+ADJACENCY reducedAdj;
+bitset reducedNeighbours[MAXN+1];
+int reducedOrder;
+
+//the original graph
+int (*originalGraph)[MAXN];
+int *originalAdj;
+bitset *originalNeighbours;
+
+//the removed vertices that are the endpoints of the path (or 0)
+int liftStart, liftEnd;
+
+//the removed vertex that is assigned to each edge of the path in H
+int assignedVertex[MAXN+1][MAXN+1];
+
+//the edges that were already tried during the current augmenting search
+int visitedEdge[MAXN+1][MAXN+1];
+int visitStamp = 0;
+
+boolean isPathEdge(int v1, int v2){
+    int difference = pathPosition[v1] - pathPosition[v2];
+    return difference == 1 || difference == -1;
+}
+
+/**
+ * Tries to assign the removed vertex x to an edge of its triangle, possibly
+ * by reassigning other removed vertices (i.e., an augmenting path search).
+ */
+boolean assignRemovedVertex(int x){
+    int i;
+    
+    for(i = 0; i < 3; i++){
+        int a = originalGraph[x][i];
+        int b = originalGraph[x][(i+1)%3];
+        if(isPathEdge(a, b) && visitedEdge[a][b] != visitStamp){
+            visitedEdge[a][b] = visitedEdge[b][a] = visitStamp;
+            int other = assignedVertex[a][b];
+            if(!other || assignRemovedVertex(other)){
+                assignedVertex[a][b] = assignedVertex[b][a] = x;
+                return TRUE;
+            }
+        }
+    }
+    
+    return FALSE;
+}
+
+/**
+ * Lifts the hamiltonian path of H in pathSequence to a hamiltonian path of
+ * the original graph.
+ * 
+ * @return returns TRUE if the path could be lifted.
+ */
+boolean liftPath(){
+    int i, x;
+    int originalOrder = originalGraph[0][0];
+    bitset toAssign = reducedVertices;
+    
+    if(liftStart){
+        REMOVE(toAssign, liftStart);
+    }
+    if(liftEnd){
+        REMOVE(toAssign, liftEnd);
+    }
+    
+    for(i = 1; i < pathLength; i++){
+        assignedVertex[pathSequence[i-1]][pathSequence[i]] = 0;
+        assignedVertex[pathSequence[i]][pathSequence[i-1]] = 0;
+    }
+    for(x = 1; x <= originalOrder; x++){
+        if(CONTAINS(toAssign, x)){
+            visitStamp++;
+            if(!assignRemovedVertex(x)){
+                return FALSE;
+            }
+        }
+    }
+    
+    int liftedSequence[MAXN];
+    int liftedLength = 0;
+    if(liftStart){
+        liftedSequence[liftedLength++] = liftStart;
+    }
+    for(i = 0; i < pathLength; i++){
+        liftedSequence[liftedLength++] = pathSequence[i];
+        if(i + 1 < pathLength && assignedVertex[pathSequence[i]][pathSequence[i+1]]){
+            liftedSequence[liftedLength++] = assignedVertex[pathSequence[i]][pathSequence[i+1]];
+        }
+    }
+    if(liftEnd){
+        liftedSequence[liftedLength++] = liftEnd;
+    }
+    
+    for(i = 0; i < liftedLength; i++){
+        pathSequence[i] = liftedSequence[i];
+        pathPosition[liftedSequence[i]] = i;
+    }
+    pathLength = liftedLength;
+    foundPath(originalGraph, originalAdj, originalNeighbours);
+    return TRUE;
+}
+
+/**
+ * Removes an independent set of degree 3 vertices from the graph.
+ * 
+ * @return returns TRUE if at least one vertex was removed.
+ */
+boolean reduceGraph(GRAPH graph, ADJACENCY adj, bitset *neighbours){
+    int i, v;
+    int order = graph[0][0];
+    
+    originalGraph = graph;
+    originalAdj = adj;
+    originalNeighbours = neighbours;
+    
+    //in a triangulation with more than 4 vertices the vertices of degree 3
+    //are independent, and H should still be a triangulation
+    reducedVertices = EMPTY_SET;
+    reducedOrder = order;
+    if(order > 4){
+        for(v = 1; v <= order && reducedOrder > 4; v++){
+            if(adj[v] == 3){
+                ADD(reducedVertices, v);
+                reducedOrder--;
+            }
+        }
+    }
+    
+    if(IS_EMPTY(reducedVertices)){
+        return FALSE;
+    }
+    
+    reducedGraph[0][0] = reducedOrder;
+    for(v = 1; v <= order; v++){
+        reducedAdj[v] = 0;
+        reducedNeighbours[v] = EMPTY_SET;
+        if(CONTAINS(reducedVertices, v)){
+            continue;
+        }
+        for(i = 0; i < adj[v]; i++){
+            if(!CONTAINS(reducedVertices, graph[v][i])){
+                reducedGraph[v][reducedAdj[v]++] = graph[v][i];
+                ADD(reducedNeighbours[v], graph[v][i]);
+            }
+        }
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Handles a hamiltonian path that was found in pathSequence.
+ * 
+ * @return returns TRUE if the path is a hamiltonian path of the original graph.
+ */
+boolean completePath(GRAPH graph, ADJACENCY adj, bitset *neighbours){
+    if(IS_NOT_EMPTY(reducedVertices)){
+        return liftPath();
+    }
+    foundPath(graph, adj, neighbours);
+    return TRUE;
+}
+
 /**
   * 
   */
 boolean continuePath(GRAPH graph, ADJACENCY adj, bitset *neighbours, int last, int targetVertex, int remaining, int unvisitedNeighboursOfTarget) {
     int i;
     
+    searchNodes++;
+    
     if(remaining==1){
         if(CONTAINS(neighbours[targetVertex], last)){
             pathSequence[pathLength] = targetVertex;
             pathPosition[targetVertex] = pathLength;
             pathLength++;
-            foundPath(graph, adj, neighbours);
-            return TRUE;
+            if(completePath(graph, adj, neighbours)){
+                return TRUE;
+            }
+            pathLength--;
+            return FALSE;
         } else {
             return FALSE;
         }
@@ -203,15 +429,370 @@ boolean startPath(GRAPH graph, ADJACENCY adj, bitset *neighbours, int startVerte
     return FALSE;
 }
 
-boolean isHamiltonianConnected(GRAPH graph, ADJACENCY adj, bitset* neighbours){
+//the generic iterative kernel startIterativePath
+#include "iterative_kernel.h"
+//the iterative kernels for fixed orders
+#include "specialised_kernels.h"
+
+//================= EDGE SELECTION ENGINE ==================
+
+/* Instead of growing the path one vertex at a time, this engine decides for
+ * each edge whether it is on the path. The endpoints need one path edge and
+ * all other vertices need two. Once a vertex has enough path edges, its other
+ * edges are excluded, and once it has just enough candidate edges, they are
+ * all included. The path edges form fragments (paths) and we store the other
+ * end of the fragment for each endpoint of a fragment. An edge between the
+ * two ends of a fragment would close a cycle, so it is excluded as soon as the
+ * fragment is formed. Since every face is a triangle, two path edges of a face
+ * exclude the third edge of that face immediately. All changes are recorded
+ * on a trail so they can be undone when backtracking.
+ */
+
+#define EDGE_UNDECIDED 0
+#define EDGE_IN 1
+#define EDGE_OUT 2
+
+int edgeState[MAXE/2];
+int edgeEnds[MAXE/2][2];
+int edgeCount;
+//the index of the edge at each position in the rotation of a vertex
+int edgeAt[MAXN+1][MAXN];
+//the index of the edge between two adjacent vertices
+int edgeBetween[MAXN+1][MAXN+1];
+
+int requiredDegree[MAXN+1];
+int inDegree[MAXN+1];
+int undecidedDegree[MAXN+1];
+
+//for the endpoints of a fragment: the other end and the number of vertices
+int otherEnd[MAXN+1];
+int fragmentSize[MAXN+1];
+
+//an edge that was decided, and the fragment ends that were joined by it
+typedef struct {
+    int edge;
+    int end1, end2;
+    int size1, size2;
+} TRAILRECORD;
+
+TRAILRECORD trail[MAXE/2];
+int trailLength;
+
+//the vertices whose degrees have to be checked
+int edgeQueue[MAXE];
+int edgeQueueLength;
+
+int edgeStart, edgeTarget, edgeOrder;
+bitset *edgeNeighbours;
+
+/**
+ * Decides the state of an undecided edge.
+ * 
+ * @return returns FALSE if this gives a vertex too many path edges or closes a
+ * cycle.
+ */
+boolean decideEdge(int e, int state){
+    int u = edgeEnds[e][0];
+    int v = edgeEnds[e][1];
+    TRAILRECORD *record = trail + trailLength++;
+    
+    record->edge = e;
+    record->end1 = 0;
+    edgeState[e] = state;
+    undecidedDegree[u]--;
+    undecidedDegree[v]--;
+    edgeQueue[edgeQueueLength++] = u;
+    edgeQueue[edgeQueueLength++] = v;
+    if(state == EDGE_OUT){
+        return TRUE;
+    }
+    
+    inDegree[u]++;
+    inDegree[v]++;
+    if(inDegree[u] > requiredDegree[u] || inDegree[v] > requiredDegree[v]){
+        return FALSE;
+    }
+    
+    //u and v are ends of their fragments
+    int a = otherEnd[u];
+    int b = otherEnd[v];
+    if(a == v){
+        return FALSE;
+    }
+    record->end1 = a;
+    record->end2 = b;
+    record->size1 = fragmentSize[a];
+    record->size2 = fragmentSize[b];
+    otherEnd[a] = b;
+    otherEnd[b] = a;
+    fragmentSize[a] = fragmentSize[b] = record->size1 + record->size2;
+    
+    //the path between the endpoints has to contain all vertices
+    if(((a == edgeStart && b == edgeTarget) || (a == edgeTarget && b == edgeStart))
+            && fragmentSize[a] < edgeOrder){
+        return FALSE;
+    }
+    //the edge between the ends would close a cycle
+    if(CONTAINS(edgeNeighbours[a], b) && edgeState[edgeBetween[a][b]] == EDGE_UNDECIDED){
+        return decideEdge(edgeBetween[a][b], EDGE_OUT);
+    }
+    return TRUE;
+}
+
+void undoEdges(int mark){
+    while(trailLength > mark){
+        TRAILRECORD *record = trail + --trailLength;
+        int u = edgeEnds[record->edge][0];
+        int v = edgeEnds[record->edge][1];
+        if(edgeState[record->edge] == EDGE_IN){
+            inDegree[u]--;
+            inDegree[v]--;
+            if(record->end1){
+                otherEnd[record->end1] = u;
+                otherEnd[record->end2] = v;
+                fragmentSize[record->end1] = record->size1;
+                fragmentSize[record->end2] = record->size2;
+            }
+        }
+        undecidedDegree[u]++;
+        undecidedDegree[v]++;
+        edgeState[record->edge] = EDGE_UNDECIDED;
+    }
+    edgeQueueLength = 0;
+}
+
+/**
+ * Applies the degree rules to the vertices in the queue until nothing changes.
+ * 
+ * @return returns FALSE if a vertex can no longer get the required number of
+ * path edges.
+ */
+boolean propagateEdges(ADJACENCY adj){
+    int i;
+    
+    while(edgeQueueLength){
+        int v = edgeQueue[--edgeQueueLength];
+        int missing = requiredDegree[v] - inDegree[v];
+        if(missing < 0 || undecidedDegree[v] < missing){
+            return FALSE;
+        }
+        if(!undecidedDegree[v] || (missing && undecidedDegree[v] > missing)){
+            continue;
+        }
+        //either all remaining edges are needed, or none of them
+        int state = missing ? EDGE_IN : EDGE_OUT;
+        for(i = 0; i < adj[v]; i++){
+            int e = edgeAt[v][i];
+            if(edgeState[e] == EDGE_UNDECIDED && !decideEdge(e, state)){
+                return FALSE;
+            }
+        }
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Follows the path edges from the start vertex and handles the path.
+ */
+boolean completeEdgePath(GRAPH graph, ADJACENCY adj, bitset *neighbours){
+    int i;
+    int previous = 0;
+    int current = edgeStart;
+    
+    for(pathLength = 0; pathLength < edgeOrder; pathLength++){
+        pathSequence[pathLength] = current;
+        pathPosition[current] = pathLength;
+        for(i = 0; i < adj[current]; i++){
+            int e = edgeAt[current][i];
+            if(edgeState[e] == EDGE_IN && graph[current][i] != previous){
+                break;
+            }
+        }
+        previous = current;
+        current = i < adj[current] ? graph[current][i] : 0;
+    }
+    return completePath(graph, adj, neighbours);
+}
+
+boolean searchEdges(GRAPH graph, ADJACENCY adj, bitset *neighbours, bitset vertices){
+    int i, v;
+    int branchVertex = 0;
+    
+    searchNodes++;
+    
+    //branch on an edge of the vertex with the fewest candidate edges
+    for(v = 1; v <= MAXN; v++){
+        if(CONTAINS(vertices, v) && inDegree[v] < requiredDegree[v] &&
+                (!branchVertex || undecidedDegree[v] < undecidedDegree[branchVertex])){
+            branchVertex = v;
+        }
+    }
+    if(!branchVertex){
+        //all degrees are right and there are no cycles
+        return completeEdgePath(graph, adj, neighbours);
+    }
+    
+    int e = -1;
+    for(i = 0; e < 0; i++){
+        if(edgeState[edgeAt[branchVertex][i]] == EDGE_UNDECIDED){
+            e = edgeAt[branchVertex][i];
+        }
+    }
+    
+    int mark = trailLength;
+    if(decideEdge(e, EDGE_IN) && propagateEdges(adj) &&
+            searchEdges(graph, adj, neighbours, vertices)){
+        return TRUE;
+    }
+    undoEdges(mark);
+    if(decideEdge(e, EDGE_OUT) && propagateEdges(adj) &&
+            searchEdges(graph, adj, neighbours, vertices)){
+        return TRUE;
+    }
+    undoEdges(mark);
+    
+    return FALSE;
+}
+
+/**
+ * Searches a hamiltonian path from startVertex to targetVertex by selecting
+ * edges. The result is the same as for startPath.
+ */
+boolean startEdgePath(GRAPH graph, ADJACENCY adj, bitset *neighbours, int startVertex, int targetVertex, int order){
+    int i, v;
+    
+    //the vertices of a reduced graph keep the labels of the original graph
+    int labels = IS_NOT_EMPTY(reducedVertices) ? originalGraph[0][0] : order;
+    bitset vertices = EMPTY_SET;
+    
+    edgeNeighbours = neighbours;
+    edgeStart = startVertex;
+    edgeTarget = targetVertex;
+    edgeOrder = order;
+    edgeCount = 0;
+    trailLength = 0;
+    edgeQueueLength = 0;
+    for(v = 1; v <= labels; v++){
+        if(!adj[v] || CONTAINS(reducedVertices, v)){
+            continue;
+        }
+        ADD(vertices, v);
+        requiredDegree[v] = (v == startVertex || v == targetVertex) ? 1 : 2;
+        inDegree[v] = 0;
+        undecidedDegree[v] = adj[v];
+        otherEnd[v] = v;
+        fragmentSize[v] = 1;
+        for(i = 0; i < adj[v]; i++){
+            int w = graph[v][i];
+            if(v < w){
+                edgeEnds[edgeCount][0] = v;
+                edgeEnds[edgeCount][1] = w;
+                edgeState[edgeCount] = EDGE_UNDECIDED;
+                edgeBetween[v][w] = edgeBetween[w][v] = edgeCount;
+                edgeCount++;
+            }
+        }
+    }
+    for(v = 1; v <= labels; v++){
+        if(CONTAINS(vertices, v)){
+            for(i = 0; i < adj[v]; i++){
+                edgeAt[v][i] = edgeBetween[v][graph[v][i]];
+            }
+            edgeQueue[edgeQueueLength++] = v;
+        }
+    }
+    
+    //the edge between the endpoints would close a cycle
+    if(CONTAINS(neighbours[startVertex], targetVertex) &&
+            !decideEdge(edgeBetween[startVertex][targetVertex], EDGE_OUT)){
+        return FALSE;
+    }
+    
+    return propagateEdges(adj) && searchEdges(graph, adj, neighbours, vertices);
+}
+
+/**
+ * Searches a hamiltonian path from startVertex to targetVertex with the
+ * selected search kernel.
+ */
+boolean startSearch(GRAPH graph, ADJACENCY adj, bitset *neighbours, int startVertex, int targetVertex, int order){
+    if(searchEngine == EDGE_ENGINE){
+        return startEdgePath(graph, adj, neighbours, startVertex, targetVertex, order);
+    }
+    if(searchEngine == SPECIALISED_ENGINE && specialisedKernels[order] != NULL){
+        return specialisedKernels[order](graph, adj, neighbours, startVertex, targetVertex, order);
+    }
+    if(searchEngine != RECURSIVE_ENGINE){
+        return startIterativePath(graph, adj, neighbours, startVertex, targetVertex, order);
+    }
+    currentPath = EMPTY_SET;
+    return startPath(graph, adj, neighbours, startVertex, targetVertex, order);
+}
+
+/**
+ * Searches a hamiltonian path from v1 to v2 in the reduced graph. A removed
+ * endpoint is replaced by each of its neighbours.
+ */
+boolean startReducedPath(int v1, int v2){
     int i, j;
     
-    //first we clear the information about which vertices are connected by a
+    liftStart = CONTAINS(reducedVertices, v1) ? v1 : 0;
+    liftEnd = CONTAINS(reducedVertices, v2) ? v2 : 0;
+    
+    for(i = 0; i < (liftStart ? 3 : 1); i++){
+        int start = liftStart ? originalGraph[v1][i] : v1;
+        for(j = 0; j < (liftEnd ? 3 : 1); j++){
+            int end = liftEnd ? originalGraph[v2][j] : v2;
+            if(start != end){
+                if(startSearch(reducedGraph, reducedAdj, reducedNeighbours,
+                        start, end, reducedOrder)){
+                    return TRUE;
+                }
+            }
+        }
+    }
+    
+    return FALSE;
+}
+
+/**
+ * Clears the information of the previous graph and removes the vertices of
+ * degree 3 if requested.
+ */
+void prepareSearch(GRAPH graph, ADJACENCY adj, bitset *neighbours, boolean reduce){
+    int i;
+    
+    //we clear the information about which vertices are connected by a
     //hamiltonian path
     for(i = 1; i<=MAXN; i++){
         connected[i] = EMPTY_SET;
     }
     
+    witnessCount = 0;
+    reducedVertices = EMPTY_SET;
+    if(reduce){
+        reduceGraph(graph, adj, neighbours);
+    }
+}
+
+/**
+ * Searches a hamiltonian path from v1 to v2, in the reduced graph if vertices
+ * were removed.
+ */
+boolean searchPair(GRAPH graph, ADJACENCY adj, bitset *neighbours, int v1, int v2){
+    if(IS_NOT_EMPTY(reducedVertices)){
+        return startReducedPath(v1, v2);
+    }
+    return startSearch(graph, adj, neighbours, v1, v2, graph[0][0]);
+}
+
+boolean isHamiltonianConnected(GRAPH graph, ADJACENCY adj, bitset* neighbours,
+        boolean reduce){
+    int i, j;
+    
+    prepareSearch(graph, adj, neighbours, reduce);
+    
     int order = graph[0][0];
     
     //next we sort the vertices according to there degree
@@ -228,24 +809,211 @@ boolean isHamiltonianConnected(GRAPH graph, ADJACENCY adj, bitset* neighbours){
         }
     }
     
+    failingPairCount = 0;
     for(i=0; i < order-1; i++){
         for(j=i+1; j< order; j++){
             int v1 = sorted[i];
             int v2 = sorted[j];
             if(!CONTAINS(connected[v1], v2)){
-                //clear old path
-                currentPath = EMPTY_SET;
-                
-                if(!startPath(graph, adj, neighbours, v1, v2, order)){
-                    return FALSE;
+                if(!searchPair(graph, adj, neighbours, v1, v2)){
+                    if(!collectFailingPairs){
+                        failingStart = v1;
+                        failingEnd = v2;
+                        return FALSE;
+                    }
+                    //the paths that are found later do not depend on the
+                    //failed pairs, so we just continue with the next pair
+                    failingPairs[failingPairCount][0] = v1;
+                    failingPairs[failingPairCount][1] = v2;
+                    failingPairCount++;
                 }
             }
         }
     }
     
+    if(failingPairCount){
+        failingStart = failingPairs[0][0];
+        failingEnd = failingPairs[0][1];
+        return FALSE;
+    }
     return TRUE;
 }
 
+//====================== QUERIES =======================
+
+#define CONNECTED_QUERY 0
+#define HAMILTONIAN_QUERY 1
+#define TRACEABLE_QUERY 2
+#define PAIR_QUERY 3
+
+//the property that is checked for each graph
+int query = CONNECTED_QUERY;
+//the vertices given for the traceable and pair queries
+int queryStart, queryEnd;
+
+/**
+ * A hamiltonian cycle passes through a vertex of minimum degree and one of its
+ * neighbours, so we only search paths between these vertices. We stop at the
+ * first path.
+ */
+boolean isHamiltonian(GRAPH graph, ADJACENCY adj, bitset *neighbours, boolean reduce){
+    int i;
+    int order = graph[0][0];
+    int v = 1;
+    
+    prepareSearch(graph, adj, neighbours, reduce);
+    
+    for(i = 2; i <= order; i++){
+        if(adj[i] < adj[v]){
+            v = i;
+        }
+    }
+    for(i = 0; i < adj[v]; i++){
+        if(searchPair(graph, adj, neighbours, v, graph[v][i])){
+            return TRUE;
+        }
+    }
+    failingStart = v;
+    failingEnd = 0;
+    return FALSE;
+}
+
+/**
+ * Searches a hamiltonian path from start to each other vertex until one is
+ * found.
+ */
+boolean isTraceableFrom(GRAPH graph, ADJACENCY adj, bitset *neighbours,
+        boolean reduce, int start){
+    int v;
+    int order = graph[0][0];
+    
+    prepareSearch(graph, adj, neighbours, reduce);
+    
+    for(v = 1; v <= order; v++){
+        if(v != start && searchPair(graph, adj, neighbours, start, v)){
+            return TRUE;
+        }
+    }
+    failingStart = start;
+    failingEnd = 0;
+    return FALSE;
+}
+
+boolean hasHamiltonianPath(GRAPH graph, ADJACENCY adj, bitset *neighbours,
+        boolean reduce, int start, int end){
+    prepareSearch(graph, adj, neighbours, reduce);
+    
+    if(searchPair(graph, adj, neighbours, start, end)){
+        return TRUE;
+    }
+    failingStart = start;
+    failingEnd = end;
+    return FALSE;
+}
+
+/**
+ * Checks the selected property for the graph.
+ */
+boolean answerQuery(GRAPH graph, ADJACENCY adj, bitset *neighbours, boolean reduce){
+    int order = graph[0][0];
+    
+    if(queryStart > order || queryEnd > order){
+        fprintf(stderr, "The graph has only %d vertices -- exiting!\n", order);
+        exit(EXIT_FAILURE);
+    }
+    switch(query){
+        case HAMILTONIAN_QUERY:
+            return isHamiltonian(graph, adj, neighbours, reduce);
+        case TRACEABLE_QUERY:
+            return isTraceableFrom(graph, adj, neighbours, reduce, queryStart);
+        case PAIR_QUERY:
+            return hasHamiltonianPath(graph, adj, neighbours, reduce, queryStart, queryEnd);
+        default:
+            return isHamiltonianConnected(graph, adj, neighbours, reduce);
+    }
+}
+
+//the name of the property in the output and in the summary
+char *queryDescriptions[] = {"hamiltonian-connected", "hamiltonian",
+        "traceable", "connected by a hamiltonian path"};
+char *queryKeys[] = {"hamiltonian_connected", "hamiltonian",
+        "traceable", "hamiltonian_path"};
+
+void writeFailingPairsHeader(FILE *f){
+    fprintf(f, "# graph: pairs that are not connected by a hamiltonian path\n");
+}
+
+void writeFailingPairs(FILE *f, unsigned long long graphIndex){
+    int i;
+    fprintf(f, "%llu:", graphIndex);
+    for(i = 0; i < failingPairCount; i++){
+        fprintf(f, " %d-%d", failingPairs[i][0], failingPairs[i][1]);
+    }
+    fprintf(f, "\n");
+}
+
+//====================== CHECKPOINTS =======================
+
+//the counters of the run, which are stored in summaries and checkpoints
+unsigned long long numberOfGraphs = 0ULL;
+//the number of graphs that have and that do not have the queried property
+unsigned long long numberOfHamiltonianConnected = 0ULL;
+unsigned long long numberOfNotHamiltonianConnected = 0ULL;
+unsigned long long numberOfPrefiltered = 0ULL;
+unsigned long long numberOfWritten = 0ULL;
+unsigned long long numberOfCrossChecked = 0ULL;
+unsigned long long graphIndex = 0ULL;
+unsigned long long residue = 0ULL;
+unsigned long long modulus = 1ULL;
+
+void storeCounters(SUMMARY *summary){
+    char key[MAXKEYLENGTH];
+    clearSummary(summary);
+    setSummaryValue(summary, "residue", residue);
+    setSummaryValue(summary, "modulus", modulus);
+    setSummaryValue(summary, "graphs", numberOfGraphs);
+    setSummaryValue(summary, queryKeys[query], numberOfHamiltonianConnected);
+    snprintf(key, MAXKEYLENGTH, "not_%s", queryKeys[query]);
+    setSummaryValue(summary, key, numberOfNotHamiltonianConnected);
+    setSummaryValue(summary, "prefiltered", numberOfPrefiltered);
+    setSummaryValue(summary, "written", numberOfWritten);
+    setSummaryValue(summary, "cross_checked", numberOfCrossChecked);
+}
+
+void restoreCounters(SUMMARY *summary){
+    char key[MAXKEYLENGTH];
+    numberOfGraphs = getSummaryValue(summary, "graphs");
+    numberOfHamiltonianConnected = getSummaryValue(summary, queryKeys[query]);
+    snprintf(key, MAXKEYLENGTH, "not_%s", queryKeys[query]);
+    numberOfNotHamiltonianConnected = getSummaryValue(summary, key);
+    numberOfPrefiltered = getSummaryValue(summary, "prefiltered");
+    numberOfWritten = getSummaryValue(summary, "written");
+    numberOfCrossChecked = getSummaryValue(summary, "cross_checked");
+    graphIndex = getSummaryValue(summary, "graph_index");
+}
+
+void saveCheckpoint(char *name, FILE *input, FILE *output, FILE *certificateFile,
+        FILE *failingPairsFile){
+    SUMMARY checkpoint;
+    storeCounters(&checkpoint);
+    setSummaryValue(&checkpoint, "graph_index", graphIndex);
+    setSummaryValue(&checkpoint, "input_offset", streamPosition(input));
+    //the outputs need to be on disk before the checkpoint refers to them
+    if(output != NULL){
+        syncStream(output);
+        setSummaryValue(&checkpoint, "output_length", streamPosition(output));
+    }
+    if(certificateFile != NULL){
+        syncStream(certificateFile);
+        setSummaryValue(&checkpoint, "certificate_length", streamPosition(certificateFile));
+    }
+    if(failingPairsFile != NULL){
+        syncStream(failingPairsFile);
+        setSummaryValue(&checkpoint, "failing_pairs_length", streamPosition(failingPairsFile));
+    }
+    writeCheckpoint(name, &checkpoint);
+}
+
  //====================== USAGE =======================
 
 void help(char *name) {
@@ -254,9 +1022,65 @@ void help(char *name) {
     fprintf(stderr, " %s [options]\n\n", name);
     fprintf(stderr, "Valid options\n=============\n");
     fprintf(stderr, "    -f, --filter\n");
-    fprintf(stderr, "       Filter graphs that are hamiltonian-connected.\n");
+    fprintf(stderr, "       Filter graphs that are hamiltonian-connected (or that have the\n");
+    fprintf(stderr, "       property of the selected query).\n");
     fprintf(stderr, "    -i, --invert\n");
     fprintf(stderr, "       Invert the filter.\n");
+    fprintf(stderr, "    -H, --hamiltonian\n");
+    fprintf(stderr, "       Only check whether the graph is hamiltonian.\n");
+    fprintf(stderr, "    -t, --traceable-from v\n");
+    fprintf(stderr, "       Only check whether there is a hamiltonian path starting in v.\n");
+    fprintf(stderr, "    -P, --pair u,v\n");
+    fprintf(stderr, "       Only check whether there is a hamiltonian path from u to v.\n");
+    fprintf(stderr, "    -e, --engine engine\n");
+    fprintf(stderr, "       The search kernel: recursive (default), iterative, specialised or\n");
+    fprintf(stderr, "       edges. The specialised kernel is the iterative kernel compiled for\n");
+    fprintf(stderr, "       a fixed order; other orders use the iterative kernel. The edges\n");
+    fprintf(stderr, "       kernel selects the edges of the path with constraint propagation.\n");
+    fprintf(stderr, "    -r, --reduce\n");
+    fprintf(stderr, "       Remove the vertices of degree 3 before searching and lift the\n");
+    fprintf(stderr, "       paths of the reduced graph.\n");
+    fprintf(stderr, "    -p, --prefilter\n");
+    fprintf(stderr, "       Reject graphs that violate a cheap necessary condition before\n");
+    fprintf(stderr, "       starting the search.\n");
+    fprintf(stderr, "    -v, --verbose\n");
+    fprintf(stderr, "       Print a pair of vertices that is not connected by a hamiltonian\n");
+    fprintf(stderr, "       path for each graph that is not hamiltonian-connected.\n");
+    fprintf(stderr, "    -c, --certificate file\n");
+    fprintf(stderr, "       Write the witness paths for each graph to this file. These can be\n");
+    fprintf(stderr, "       checked by hamconntri_verify.\n");
+    fprintf(stderr, "    -a, --all-failing-pairs file\n");
+    fprintf(stderr, "       Continue the search after a pair without a hamiltonian path, and\n");
+    fprintf(stderr, "       write all such pairs of each graph that is not hamiltonian-\n");
+    fprintf(stderr, "       connected to this file, one line per graph.\n");
+    fprintf(stderr, "    -z, --compress type\n");
+    fprintf(stderr, "       Compress the filtered graphs with gzip or zstd. Compressed input is\n");
+    fprintf(stderr, "       always recognised automatically.\n");
+    fprintf(stderr, "    -m, --part res/mod\n");
+    fprintf(stderr, "       Only process the graphs whose index modulo mod is res (the first\n");
+    fprintf(stderr, "       graph has index 0). The other graphs are skipped without decoding.\n");
+    fprintf(stderr, "    -s, --summary file\n");
+    fprintf(stderr, "       Write the counters to this file in a machine-readable form. The\n");
+    fprintf(stderr, "       summaries of several parts can be combined by hamconntri_merge.\n");
+    fprintf(stderr, "    -x, --cross-check fraction\n");
+    fprintf(stderr, "       Check the result for a random fraction of the graphs with a\n");
+    fprintf(stderr, "       brute-force search and exit at the first disagreement.\n");
+    fprintf(stderr, "    -X, --cross-check-seed seed\n");
+    fprintf(stderr, "       The seed for selecting the graphs that are cross-checked.\n");
+    fprintf(stderr, "    -k, --checkpoint file\n");
+    fprintf(stderr, "       Regularly store the position in the input, the lengths of the\n");
+    fprintf(stderr, "       output files and the counters in this file.\n");
+    fprintf(stderr, "    -K, --checkpoint-interval seconds\n");
+    fprintf(stderr, "       The time between two checkpoints (default 600).\n");
+    fprintf(stderr, "    -R, --resume\n");
+    fprintf(stderr, "       Continue an interrupted run from the checkpoint. The filtered graphs\n");
+    fprintf(stderr, "       have to be appended to the original output, e.g., using >>.\n");
+    fprintf(stderr, "    -b, --bench label\n");
+    fprintf(stderr, "       Time each graph and print a report per order for this label.\n");
+    fprintf(stderr, "    -B, --bench-baseline file\n");
+    fprintf(stderr, "       Compare the benchmark report to the records in this file.\n");
+    fprintf(stderr, "    -O, --bench-output file\n");
+    fprintf(stderr, "       Append the benchmark records to this file.\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -271,16 +1095,51 @@ int main(int argc, char *argv[]) {
     /*=========== commandline parsing ===========*/
     boolean invert = FALSE;
     boolean filter = FALSE;
+    boolean prefilter = FALSE;
+    boolean reduce = FALSE;
+    boolean verbose = FALSE;
+    char *certificateName = NULL;
+    char *failingPairsName = NULL;
+    int compression = NO_COMPRESSION;
+    char *summaryName = NULL;
+    double crossCheckFraction = 0.0;
+    char *checkpointName = NULL;
+    int checkpointInterval = 600;
+    boolean resume = FALSE;
+    char *benchLabel = NULL;
+    char *benchBaseline = NULL;
+    char *benchOutput = NULL;
     int c;
     char *name = argv[0];
     static struct option long_options[] = {
         {"invert", no_argument, NULL, 'i'},
         {"filter", no_argument, NULL, 'f'},
-        {"help", no_argument, NULL, 'h'}
+        {"hamiltonian", no_argument, NULL, 'H'},
+        {"traceable-from", required_argument, NULL, 't'},
+        {"pair", required_argument, NULL, 'P'},
+        {"engine", required_argument, NULL, 'e'},
+        {"reduce", no_argument, NULL, 'r'},
+        {"prefilter", no_argument, NULL, 'p'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"certificate", required_argument, NULL, 'c'},
+        {"all-failing-pairs", required_argument, NULL, 'a'},
+        {"compress", required_argument, NULL, 'z'},
+        {"part", required_argument, NULL, 'm'},
+        {"summary", required_argument, NULL, 's'},
+        {"cross-check", required_argument, NULL, 'x'},
+        {"cross-check-seed", required_argument, NULL, 'X'},
+        {"checkpoint", required_argument, NULL, 'k'},
+        {"checkpoint-interval", required_argument, NULL, 'K'},
+        {"resume", no_argument, NULL, 'R'},
+        {"bench", required_argument, NULL, 'b'},
+        {"bench-baseline", required_argument, NULL, 'B'},
+        {"bench-output", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hif", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hifHt:P:e:rpvc:a:z:m:s:x:X:k:K:Rb:B:O:", long_options, &option_index)) != -1) {
         switch (c) {
             case 'i':
                 invert = TRUE;
@@ -288,6 +1147,110 @@ int main(int argc, char *argv[]) {
             case 'f':
                 filter = TRUE;
                 break;
+            case 'H':
+                query = HAMILTONIAN_QUERY;
+                break;
+            case 't':
+                query = TRACEABLE_QUERY;
+                queryStart = atoi(optarg);
+                if(queryStart < 1){
+                    fprintf(stderr, "Illegal vertex %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'P':
+                query = PAIR_QUERY;
+                if(sscanf(optarg, "%d,%d", &queryStart, &queryEnd) != 2 ||
+                        queryStart < 1 || queryEnd < 1 || queryStart == queryEnd){
+                    fprintf(stderr, "Illegal pair %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'e':
+                if(strcmp(optarg, "recursive") == 0){
+                    searchEngine = RECURSIVE_ENGINE;
+                } else if(strcmp(optarg, "iterative") == 0){
+                    searchEngine = ITERATIVE_ENGINE;
+                } else if(strcmp(optarg, "specialised") == 0){
+                    searchEngine = SPECIALISED_ENGINE;
+                } else if(strcmp(optarg, "edges") == 0){
+                    searchEngine = EDGE_ENGINE;
+                } else {
+                    fprintf(stderr, "Unknown engine %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'r':
+                reduce = TRUE;
+                break;
+            case 'p':
+                prefilter = TRUE;
+                break;
+            case 'v':
+                verbose = TRUE;
+                break;
+            case 'c':
+                certificateName = optarg;
+                break;
+            case 'a':
+                failingPairsName = optarg;
+                collectFailingPairs = TRUE;
+                break;
+            case 'z':
+                compression = parseCompression(optarg);
+                if(compression < 0){
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'm':
+                if(sscanf(optarg, "%llu/%llu", &residue, &modulus) != 2 ||
+                        residue >= modulus){
+                    fprintf(stderr, "Illegal part %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 's':
+                summaryName = optarg;
+                break;
+            case 'x':
+                crossCheckFraction = atof(optarg);
+                if(crossCheckFraction <= 0.0 || crossCheckFraction > 1.0){
+                    fprintf(stderr, "Illegal cross-check fraction %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'X':
+                seedCrossCheck(strtoull(optarg, NULL, 10));
+                break;
+            case 'k':
+                checkpointName = optarg;
+                break;
+            case 'K':
+                checkpointInterval = atoi(optarg);
+                if(checkpointInterval <= 0){
+                    fprintf(stderr, "Illegal checkpoint interval %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'R':
+                resume = TRUE;
+                break;
+            case 'b':
+                benchLabel = optarg;
+                break;
+            case 'B':
+                benchBaseline = optarg;
+                break;
+            case 'O':
+                benchOutput = optarg;
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -300,47 +1263,231 @@ int main(int argc, char *argv[]) {
                 return EXIT_FAILURE;
         }
     }
+
+    //certificates, the prefilter and the cross-check are about
+    //hamiltonian-connectedness
+    if(query != CONNECTED_QUERY && (certificateName != NULL || prefilter ||
+            crossCheckFraction > 0.0 || failingPairsName != NULL)){
+        fprintf(stderr, "Certificates, failing pairs, the prefilter and the cross-check can\nonly be used for hamiltonian-connectedness.\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    //the prefilter does not give all failing pairs
+    if(failingPairsName != NULL && prefilter){
+        fprintf(stderr, "The prefilter cannot be used when writing all failing pairs.\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    if(resume && checkpointName == NULL){
+        fprintf(stderr, "A checkpoint is needed to resume a run.\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    //the filtered graphs can only be truncated to a checkpoint if they are
+    //written uncompressed to a regular file
+    if(checkpointName != NULL && filter &&
+            (compression != NO_COMPRESSION || ftello(stdout) < 0)){
+        fprintf(stderr, "Checkpoints need uncompressed output to a file -- exiting!\n");
+        return EXIT_FAILURE;
+    }
     
     /*=========== process graphs ===========*/
     GRAPH graph;
     ADJACENCY adj;
     bitset *neighbours = (bitset *)malloc(sizeof(bitset)*MAXN);
-    unsigned long long numberOfGraphs = 0ULL;
-    unsigned long long numberOfHamiltonianConnected = 0ULL;
-    unsigned long long numberOfNotHamiltonianConnected = 0ULL;
     unsigned short code[MAXCODELENGTH];
     int length;
-    if(filter){
-        writePlanarCodeHeader(stdout);
+    FILE *input = openInputStream(stdin);
+    FILE *output = NULL;
+    FILE *certificateFile = NULL;
+    FILE *failingPairsFile = NULL;
+    if(resume){
+        SUMMARY checkpoint;
+        if(!readCheckpoint(checkpointName, &checkpoint)){
+            fprintf(stderr, "Could not read checkpoint %s -- exiting!\n", checkpointName);
+            return EXIT_FAILURE;
+        }
+        if(getSummaryValue(&checkpoint, "residue") != residue ||
+                getSummaryValue(&checkpoint, "modulus") != modulus){
+            fprintf(stderr, "The checkpoint belongs to another part -- exiting!\n");
+            return EXIT_FAILURE;
+        }
+        if(filter != (getSummaryValue(&checkpoint, "output_length") != 0) ||
+                (certificateName != NULL) != (getSummaryValue(&checkpoint, "certificate_length") != 0) ||
+                (failingPairsName != NULL) != (getSummaryValue(&checkpoint, "failing_pairs_length") != 0)){
+            fprintf(stderr, "The checkpoint was written with other outputs -- exiting!\n");
+            return EXIT_FAILURE;
+        }
+        restoreCounters(&checkpoint);
+        skipGraphs(input, graphIndex, getSummaryValue(&checkpoint, "input_offset"));
+        if(filter){
+            output = stdout;
+            truncateStream(output, getSummaryValue(&checkpoint, "output_length"));
+        }
+        if(certificateName != NULL){
+            certificateFile = fopen(certificateName, "r+b");
+            if(certificateFile == NULL){
+                fprintf(stderr, "Could not open %s -- exiting!\n", certificateName);
+                return EXIT_FAILURE;
+            }
+            truncateStream(certificateFile, getSummaryValue(&checkpoint, "certificate_length"));
+            storeWitnesses = TRUE;
+        }
+        if(failingPairsName != NULL){
+            failingPairsFile = fopen(failingPairsName, "r+");
+            if(failingPairsFile == NULL){
+                fprintf(stderr, "Could not open %s -- exiting!\n", failingPairsName);
+                return EXIT_FAILURE;
+            }
+            truncateStream(failingPairsFile, getSummaryValue(&checkpoint, "failing_pairs_length"));
+        }
+    } else {
+        if(filter){
+            output = openOutputStream(stdout, compression);
+            writePlanarCodeHeader(output);
+        }
+        if(certificateName != NULL){
+            certificateFile = fopen(certificateName, "wb");
+            if(certificateFile == NULL){
+                fprintf(stderr, "Could not open %s -- exiting!\n", certificateName);
+                return EXIT_FAILURE;
+            }
+            writeCertificateHeader(certificateFile);
+            storeWitnesses = TRUE;
+        }
+        if(failingPairsName != NULL){
+            failingPairsFile = fopen(failingPairsName, "w");
+            if(failingPairsFile == NULL){
+                fprintf(stderr, "Could not open %s -- exiting!\n", failingPairsName);
+                return EXIT_FAILURE;
+            }
+            writeFailingPairsHeader(failingPairsFile);
+        }
     }
-    while (readPlanarCode(code, &length, stdin)) {
+    time_t lastCheckpoint = time(NULL);
+    while (readPlanarCode(code, &length, input)) {
+        if((graphIndex++) % modulus != residue){
+            continue;
+        }
         decodePlanarCode(code, graph, adj, neighbours);
-        if(isHamiltonianConnected(graph, adj, neighbours)){
+        if(benchLabel != NULL){
+            searchNodes = 0ULL;
+            startTiming();
+        }
+        boolean hamiltonianConnected;
+        boolean prefiltered = prefilter && violatesScatteringCondition(graph,
+                adj, neighbours, &failingStart, &failingEnd);
+        if(prefiltered){
+            hamiltonianConnected = FALSE;
+            numberOfPrefiltered++;
+        } else {
+            hamiltonianConnected = answerQuery(graph, adj, neighbours, reduce);
+        }
+        if(benchLabel != NULL){
+            stopTiming(code[0], searchNodes);
+        }
+        if(certificateFile != NULL){
+            writeCertificate(certificateFile, witnesses,
+                    hamiltonianConnected ? witnessCount : 0, code[0]);
+        }
+        if(crossCheckFraction > 0.0 && sampleForCrossCheck(crossCheckFraction)){
+            crossCheck(graph, adj, graphIndex, hamiltonianConnected,
+                    prefiltered ? NULL : connected, failingStart, failingEnd);
+            numberOfCrossChecked++;
+        }
+        if(hamiltonianConnected){
             numberOfHamiltonianConnected++;
             if(filter && !invert){
-                writeCode(stdout, code, length);
+                writeCode(output, code, length);
+                numberOfWritten++;
             }
         } else {
             numberOfNotHamiltonianConnected++;
+            if(failingPairsFile != NULL){
+                writeFailingPairs(failingPairsFile, graphIndex);
+            }
+            if(verbose && failingEnd){
+                fprintf(stderr, "Graph %llu: no hamiltonian path between %d and %d.\n",
+                        graphIndex, failingStart, failingEnd);
+            } else if(verbose && query == HAMILTONIAN_QUERY){
+                fprintf(stderr, "Graph %llu: no hamiltonian cycle.\n", graphIndex);
+            } else if(verbose){
+                fprintf(stderr, "Graph %llu: no hamiltonian path starts in %d.\n",
+                        graphIndex, failingStart);
+            }
             if(filter && invert){
-                writeCode(stdout, code, length);
+                writeCode(output, code, length);
+                numberOfWritten++;
             }
         }
         numberOfGraphs++;
+        if(checkpointName != NULL && time(NULL) - lastCheckpoint >= checkpointInterval){
+            saveCheckpoint(checkpointName, input, output, certificateFile,
+                    failingPairsFile);
+            lastCheckpoint = time(NULL);
+        }
+    }
+    if(checkpointName != NULL){
+        saveCheckpoint(checkpointName, input, output, certificateFile,
+                failingPairsFile);
     }
     
     fprintf(stderr, "Read %llu graph%s.\n", numberOfGraphs, 
                 numberOfGraphs==1 ? "" : "s");
     
-    fprintf(stderr, "   %llu graph%s %s hamiltonian-connected.\n",
+    fprintf(stderr, "   %llu graph%s %s %s.\n",
                 numberOfHamiltonianConnected, 
                 numberOfHamiltonianConnected==1 ? "" : "s", 
-                numberOfHamiltonianConnected==1 ? "was" : "were");
-    fprintf(stderr, "   %llu graph%s %s not hamiltonian-connected.\n",
+                numberOfHamiltonianConnected==1 ? "was" : "were",
+                queryDescriptions[query]);
+    fprintf(stderr, "   %llu graph%s %s not %s.\n",
                 numberOfNotHamiltonianConnected, 
                 numberOfNotHamiltonianConnected==1 ? "" : "s", 
-                numberOfNotHamiltonianConnected==1 ? "was" : "were");
+                numberOfNotHamiltonianConnected==1 ? "was" : "were",
+                queryDescriptions[query]);
+    if(prefilter){
+        fprintf(stderr, "   %llu graph%s %s rejected by the prefilter.\n",
+                numberOfPrefiltered,
+                numberOfPrefiltered==1 ? "" : "s",
+                numberOfPrefiltered==1 ? "was" : "were");
+    }
+    if(crossCheckFraction > 0.0){
+        fprintf(stderr, "   %llu graph%s %s cross-checked.\n",
+                numberOfCrossChecked,
+                numberOfCrossChecked==1 ? "" : "s",
+                numberOfCrossChecked==1 ? "was" : "were");
+    }
     
+    if(certificateFile != NULL){
+        fclose(certificateFile);
+    }
+    
+    if(failingPairsFile != NULL){
+        fclose(failingPairsFile);
+    }
+    
+    if(output != NULL){
+        fclose(output);
+    }
+    
+    if(summaryName != NULL){
+        FILE *summaryFile = fopen(summaryName, "w");
+        if(summaryFile == NULL){
+            fprintf(stderr, "Could not open %s -- exiting!\n", summaryName);
+            return EXIT_FAILURE;
+        }
+        SUMMARY summary;
+        storeCounters(&summary);
+        writeSummary(summaryFile, &summary);
+        fclose(summaryFile);
+    }
+    
+    if(benchLabel != NULL){
+        writeBenchmarkReport(stderr, benchLabel, benchBaseline);
+        if(benchOutput != NULL){
+            appendBenchmarkRecords(benchOutput, benchLabel);
+        }
+    }
 
     return EXIT_SUCCESS;
 }
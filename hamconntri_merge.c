@@ -0,0 +1,241 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Combines the results of runs on the parts res/mod of an input file into
+ * the result of a single run. The counters of the summaries are added. The
+ * filtered graphs are either concatenated in the order of the residues, or,
+ * if the original input is given, put in the same order as in the input.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include "bitset.h"
+#include "lw_plane_graph.h"
+#include "boolean.h"
+#include "summary.h"
+#include "compression.h"
+
+#define MAXPARTS 1024
+
+boolean sameCode(unsigned short *code1, int length1, unsigned short *code2, int length2){
+    int i;
+    if(length1 != length2){
+        return FALSE;
+    }
+    for(i = 0; i < length1; i++){
+        if(code1[i] != code2[i]){
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+ //====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "The program %s combines the summaries and filtered graphs of runs\non the parts res/mod of an input file.\n\n", name);
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options] summary...\n\n", name);
+    fprintf(stderr, "The merged summary is written to standard out.\n\n");
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -g, --graphs file\n");
+    fprintf(stderr, "       The filtered graphs of a part. If this option is used, it has to be\n");
+    fprintf(stderr, "       given once for each summary, in the same order.\n");
+    fprintf(stderr, "    -o, --output file\n");
+    fprintf(stderr, "       Write the merged filtered graphs to this file.\n");
+    fprintf(stderr, "    -i, --input file\n");
+    fprintf(stderr, "       The original input. The merged graphs are put in the same order as\n");
+    fprintf(stderr, "       in a single run.\n");
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options] summary...\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+int main(int argc, char *argv[]) {
+
+    /*=========== commandline parsing ===========*/
+    char *graphNames[MAXPARTS];
+    int graphCount = 0;
+    char *outputName = NULL;
+    char *inputName = NULL;
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"graphs", required_argument, NULL, 'g'},
+        {"output", required_argument, NULL, 'o'},
+        {"input", required_argument, NULL, 'i'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "hg:o:i:", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'g':
+                if(graphCount == MAXPARTS){
+                    fprintf(stderr, "Too many parts.\n");
+                    return EXIT_FAILURE;
+                }
+                graphNames[graphCount++] = optarg;
+                break;
+            case 'o':
+                outputName = optarg;
+                break;
+            case 'i':
+                inputName = optarg;
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    int partCount = argc - optind;
+    if(partCount < 1 || partCount > MAXPARTS ||
+            (graphCount && graphCount != partCount) ||
+            (graphCount && outputName == NULL)){
+        usage(name);
+        return EXIT_FAILURE;
+    }
+
+    /*=========== merge summaries ===========*/
+    SUMMARY merged, summary;
+    //the index of the part for each residue
+    int partOfResidue[MAXPARTS];
+    unsigned long long modulus = 0ULL;
+    int i, j;
+
+    clearSummary(&merged);
+    setSummaryValue(&merged, "residue", 0ULL);
+    setSummaryValue(&merged, "modulus", 1ULL);
+    for(i = 0; i < partCount; i++){
+        partOfResidue[i] = -1;
+    }
+    for(i = 0; i < partCount; i++){
+        FILE *f = fopen(argv[optind + i], "r");
+        if(f == NULL || !readSummary(f, &summary)){
+            fprintf(stderr, "Could not read summary %s -- exiting!\n", argv[optind + i]);
+            return EXIT_FAILURE;
+        }
+        fclose(f);
+
+        unsigned long long residue = getSummaryValue(&summary, "residue");
+        if(i == 0){
+            modulus = getSummaryValue(&summary, "modulus");
+        }
+        if(getSummaryValue(&summary, "modulus") != modulus || modulus != partCount
+                || residue >= modulus || partOfResidue[residue] != -1){
+            fprintf(stderr, "The summaries should describe each part res/%llu exactly once -- exiting!\n",
+                    modulus);
+            return EXIT_FAILURE;
+        }
+        partOfResidue[residue] = i;
+
+        for(j = 0; j < summary.size; j++){
+            if(strcmp(summary.keys[j], "residue") && strcmp(summary.keys[j], "modulus")){
+                setSummaryValue(&merged, summary.keys[j],
+                        getSummaryValue(&merged, summary.keys[j]) + summary.values[j]);
+            }
+        }
+    }
+
+    /*=========== merge graphs ===========*/
+    if(graphCount){
+        FILE *parts[MAXPARTS];
+        unsigned short code[MAXCODELENGTH];
+        int length;
+        unsigned long long numberOfWritten = 0ULL;
+
+        FILE *output = fopen(outputName, "wb");
+        if(output == NULL){
+            fprintf(stderr, "Could not open %s -- exiting!\n", outputName);
+            return EXIT_FAILURE;
+        }
+        for(i = 0; i < partCount; i++){
+            parts[i] = fopen(graphNames[partOfResidue[i]], "rb");
+            if(parts[i] == NULL){
+                fprintf(stderr, "Could not open %s -- exiting!\n", graphNames[partOfResidue[i]]);
+                return EXIT_FAILURE;
+            }
+            parts[i] = openInputStream(parts[i]);
+        }
+        writePlanarCodeHeader(output);
+
+        if(inputName == NULL){
+            for(i = 0; i < partCount; i++){
+                while(readPlanarCode(code, &length, parts[i])){
+                    writeCode(output, code, length);
+                    numberOfWritten++;
+                }
+            }
+        } else {
+            //the next filtered graph of each part
+            static unsigned short pending[MAXPARTS][MAXCODELENGTH];
+            int pendingLength[MAXPARTS];
+            boolean hasPending[MAXPARTS];
+            unsigned long long graphIndex = 0ULL;
+
+            FILE *input = fopen(inputName, "rb");
+            if(input == NULL){
+                fprintf(stderr, "Could not open %s -- exiting!\n", inputName);
+                return EXIT_FAILURE;
+            }
+            input = openInputStream(input);
+            for(i = 0; i < partCount; i++){
+                hasPending[i] = readPlanarCode(pending[i], pendingLength + i, parts[i]);
+            }
+            //the filtered graphs of a part are a subsequence of the graphs
+            //of that part in the input
+            while(readPlanarCode(code, &length, input)){
+                int residue = (graphIndex++) % modulus;
+                if(hasPending[residue] && sameCode(code, length,
+                        pending[residue], pendingLength[residue])){
+                    writeCode(output, code, length);
+                    numberOfWritten++;
+                    hasPending[residue] = readPlanarCode(pending[residue],
+                            pendingLength + residue, parts[residue]);
+                }
+            }
+            fclose(input);
+            for(i = 0; i < partCount; i++){
+                if(hasPending[i]){
+                    fprintf(stderr, "The graphs of part %d/%d do not occur in %s -- exiting!\n",
+                            i, partCount, inputName);
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+
+        for(i = 0; i < partCount; i++){
+            fclose(parts[i]);
+        }
+        fclose(output);
+
+        if(numberOfWritten != getSummaryValue(&merged, "written")){
+            fprintf(stderr, "Merged %llu graphs, but the summaries report %llu -- exiting!\n",
+                    numberOfWritten, getSummaryValue(&merged, "written"));
+            return EXIT_FAILURE;
+        }
+    }
+
+    writeSummary(stdout, &merged);
+
+    return EXIT_SUCCESS;
+}
@@ -9,9 +9,16 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <getopt.h>
+#include <time.h>
 #include "bitset.h"
 #include "lw_plane_graph.h"
 #include "boolean.h"
+#include "bench.h"
+#include "prefilter.h"
+#include "summary.h"
+#include "compression.h"
+#include "checkpoint.h"
+#include "oracle.h"
 
 bitset currentPath;
 int pathSequence[MAXN];
@@ -19,6 +26,12 @@ int pathPosition[MAXN+1];
 int pathLength;
 bitset connected[MAXN+1];
 
+//the number of calls to continuePath, used for benchmarking
+unsigned long long searchNodes = 0ULL;
+
+//a pair of vertices that is not connected by a hamiltonian path
+int failingStart, failingEnd;
+
 void derivePathDepth1_fromStart(GRAPH graph, ADJACENCY adj, bitset *neighbours,
         int xi, int xi1, int end){
     int i;
@@ -39,7 +52,8 @@ void derivePathDepth1_fromStart(GRAPH graph, ADJACENCY adj, bitset *neighbours,
         int yi = graph[end][i];
         if(yi!=pathSequence[0]){
             //the other case is already handled by ham cycle
-            int direction = (pathPosition[yi] < xi1Pos) ? -1 : 1;
+            //for yi = x_{i-1} (the new start) the successor is x_{i-2}
+            int direction = (pathPosition[yi] <= xi1Pos) ? -1 : 1;
             int yi1 = pathSequence[pathPosition[yi]+direction];
             ADD(connected[yi1], xi1);
             ADD(connected[xi1], yi1);
@@ -120,6 +134,8 @@ void foundPath(GRAPH graph, ADJACENCY adj, bitset *neighbours){
 boolean continuePath(GRAPH graph, ADJACENCY adj, bitset *neighbours, int last, int targetVertex, int remaining, int unvisitedNeighboursOfTarget) {
     int i;
     
+    searchNodes++;
+    
     if(remaining==1){
         if(CONTAINS(neighbours[targetVertex], last)){
             pathSequence[pathLength] = targetVertex;
@@ -226,6 +242,8 @@ boolean isHamiltonianConnected(GRAPH graph, ADJACENCY adj, bitset* neighbours){
                 currentPath = EMPTY_SET;
                 
                 if(!startPath(graph, adj, neighbours, v1, v2, order)){
+                    failingStart = v1;
+                    failingEnd = v2;
                     return FALSE;
                 }
             }
@@ -235,6 +253,54 @@ boolean isHamiltonianConnected(GRAPH graph, ADJACENCY adj, bitset* neighbours){
     return TRUE;
 }
 
+//====================== CHECKPOINTS =======================
+
+//the counters of the run, which are stored in summaries and checkpoints
+unsigned long long numberOfGraphs = 0ULL;
+unsigned long long numberOfHamiltonianConnected = 0ULL;
+unsigned long long numberOfNotHamiltonianConnected = 0ULL;
+unsigned long long numberOfPrefiltered = 0ULL;
+unsigned long long numberOfWritten = 0ULL;
+unsigned long long numberOfCrossChecked = 0ULL;
+unsigned long long graphIndex = 0ULL;
+unsigned long long residue = 0ULL;
+unsigned long long modulus = 1ULL;
+
+void storeCounters(SUMMARY *summary){
+    clearSummary(summary);
+    setSummaryValue(summary, "residue", residue);
+    setSummaryValue(summary, "modulus", modulus);
+    setSummaryValue(summary, "graphs", numberOfGraphs);
+    setSummaryValue(summary, "hamiltonian_connected", numberOfHamiltonianConnected);
+    setSummaryValue(summary, "not_hamiltonian_connected", numberOfNotHamiltonianConnected);
+    setSummaryValue(summary, "prefiltered", numberOfPrefiltered);
+    setSummaryValue(summary, "written", numberOfWritten);
+    setSummaryValue(summary, "cross_checked", numberOfCrossChecked);
+}
+
+void restoreCounters(SUMMARY *summary){
+    numberOfGraphs = getSummaryValue(summary, "graphs");
+    numberOfHamiltonianConnected = getSummaryValue(summary, "hamiltonian_connected");
+    numberOfNotHamiltonianConnected = getSummaryValue(summary, "not_hamiltonian_connected");
+    numberOfPrefiltered = getSummaryValue(summary, "prefiltered");
+    numberOfWritten = getSummaryValue(summary, "written");
+    numberOfCrossChecked = getSummaryValue(summary, "cross_checked");
+    graphIndex = getSummaryValue(summary, "graph_index");
+}
+
+void saveCheckpoint(char *name, FILE *input, FILE *output){
+    SUMMARY checkpoint;
+    storeCounters(&checkpoint);
+    setSummaryValue(&checkpoint, "graph_index", graphIndex);
+    setSummaryValue(&checkpoint, "input_offset", streamPosition(input));
+    //the output needs to be on disk before the checkpoint refers to it
+    if(output != NULL){
+        syncStream(output);
+        setSummaryValue(&checkpoint, "output_length", streamPosition(output));
+    }
+    writeCheckpoint(name, &checkpoint);
+}
+
  //====================== USAGE =======================
 
 void help(char *name) {
@@ -246,6 +312,40 @@ void help(char *name) {
     fprintf(stderr, "       Filter graphs that are hamiltonian-connected.\n");
     fprintf(stderr, "    -i, --invert\n");
     fprintf(stderr, "       Invert the filter.\n");
+    fprintf(stderr, "    -p, --prefilter\n");
+    fprintf(stderr, "       Reject graphs that violate a cheap necessary condition before\n");
+    fprintf(stderr, "       starting the search.\n");
+    fprintf(stderr, "    -v, --verbose\n");
+    fprintf(stderr, "       Print a pair of vertices that is not connected by a hamiltonian\n");
+    fprintf(stderr, "       path for each graph that is not hamiltonian-connected.\n");
+    fprintf(stderr, "    -z, --compress type\n");
+    fprintf(stderr, "       Compress the filtered graphs with gzip or zstd. Compressed input is\n");
+    fprintf(stderr, "       always recognised automatically.\n");
+    fprintf(stderr, "    -m, --part res/mod\n");
+    fprintf(stderr, "       Only process the graphs whose index modulo mod is res (the first\n");
+    fprintf(stderr, "       graph has index 0). The other graphs are skipped without decoding.\n");
+    fprintf(stderr, "    -s, --summary file\n");
+    fprintf(stderr, "       Write the counters to this file in a machine-readable form. The\n");
+    fprintf(stderr, "       summaries of several parts can be combined by hamconntri_merge.\n");
+    fprintf(stderr, "    -x, --cross-check fraction\n");
+    fprintf(stderr, "       Check the result for a random fraction of the graphs with a\n");
+    fprintf(stderr, "       brute-force search and exit at the first disagreement.\n");
+    fprintf(stderr, "    -X, --cross-check-seed seed\n");
+    fprintf(stderr, "       The seed for selecting the graphs that are cross-checked.\n");
+    fprintf(stderr, "    -k, --checkpoint file\n");
+    fprintf(stderr, "       Regularly store the position in the input, the length of the\n");
+    fprintf(stderr, "       output and the counters in this file.\n");
+    fprintf(stderr, "    -K, --checkpoint-interval seconds\n");
+    fprintf(stderr, "       The time between two checkpoints (default 600).\n");
+    fprintf(stderr, "    -R, --resume\n");
+    fprintf(stderr, "       Continue an interrupted run from the checkpoint. The filtered graphs\n");
+    fprintf(stderr, "       have to be appended to the original output, e.g., using >>.\n");
+    fprintf(stderr, "    -b, --bench label\n");
+    fprintf(stderr, "       Time each graph and print a report per order for this label.\n");
+    fprintf(stderr, "    -B, --bench-baseline file\n");
+    fprintf(stderr, "       Compare the benchmark report to the records in this file.\n");
+    fprintf(stderr, "    -O, --bench-output file\n");
+    fprintf(stderr, "       Append the benchmark records to this file.\n");
     fprintf(stderr, "    -h, --help\n");
     fprintf(stderr, "       Print this help and return.\n");
 }
@@ -260,16 +360,41 @@ int main(int argc, char *argv[]) {
     /*=========== commandline parsing ===========*/
     boolean invert = FALSE;
     boolean filter = FALSE;
+    boolean prefilter = FALSE;
+    boolean verbose = FALSE;
+    int compression = NO_COMPRESSION;
+    char *summaryName = NULL;
+    double crossCheckFraction = 0.0;
+    char *checkpointName = NULL;
+    int checkpointInterval = 600;
+    boolean resume = FALSE;
+    char *benchLabel = NULL;
+    char *benchBaseline = NULL;
+    char *benchOutput = NULL;
     int c;
     char *name = argv[0];
     static struct option long_options[] = {
         {"invert", no_argument, NULL, 'i'},
         {"filter", no_argument, NULL, 'f'},
-        {"help", no_argument, NULL, 'h'}
+        {"prefilter", no_argument, NULL, 'p'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"compress", required_argument, NULL, 'z'},
+        {"part", required_argument, NULL, 'm'},
+        {"summary", required_argument, NULL, 's'},
+        {"cross-check", required_argument, NULL, 'x'},
+        {"cross-check-seed", required_argument, NULL, 'X'},
+        {"checkpoint", required_argument, NULL, 'k'},
+        {"checkpoint-interval", required_argument, NULL, 'K'},
+        {"resume", no_argument, NULL, 'R'},
+        {"bench", required_argument, NULL, 'b'},
+        {"bench-baseline", required_argument, NULL, 'B'},
+        {"bench-output", required_argument, NULL, 'O'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
     };
     int option_index = 0;
 
-    while ((c = getopt_long(argc, argv, "hif", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hifpvz:m:s:x:X:k:K:Rb:B:O:", long_options, &option_index)) != -1) {
         switch (c) {
             case 'i':
                 invert = TRUE;
@@ -277,6 +402,64 @@ int main(int argc, char *argv[]) {
             case 'f':
                 filter = TRUE;
                 break;
+            case 'p':
+                prefilter = TRUE;
+                break;
+            case 'v':
+                verbose = TRUE;
+                break;
+            case 'z':
+                compression = parseCompression(optarg);
+                if(compression < 0){
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'm':
+                if(sscanf(optarg, "%llu/%llu", &residue, &modulus) != 2 ||
+                        residue >= modulus){
+                    fprintf(stderr, "Illegal part %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 's':
+                summaryName = optarg;
+                break;
+            case 'x':
+                crossCheckFraction = atof(optarg);
+                if(crossCheckFraction <= 0.0 || crossCheckFraction > 1.0){
+                    fprintf(stderr, "Illegal cross-check fraction %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'X':
+                seedCrossCheck(strtoull(optarg, NULL, 10));
+                break;
+            case 'k':
+                checkpointName = optarg;
+                break;
+            case 'K':
+                checkpointInterval = atoi(optarg);
+                if(checkpointInterval <= 0){
+                    fprintf(stderr, "Illegal checkpoint interval %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'R':
+                resume = TRUE;
+                break;
+            case 'b':
+                benchLabel = optarg;
+                break;
+            case 'B':
+                benchBaseline = optarg;
+                break;
+            case 'O':
+                benchOutput = optarg;
+                break;
             case 'h':
                 help(name);
                 return EXIT_SUCCESS;
@@ -289,33 +472,105 @@ int main(int argc, char *argv[]) {
                 return EXIT_FAILURE;
         }
     }
+
+    if(resume && checkpointName == NULL){
+        fprintf(stderr, "A checkpoint is needed to resume a run.\n");
+        usage(name);
+        return EXIT_FAILURE;
+    }
+    //the filtered graphs can only be truncated to a checkpoint if they are
+    //written uncompressed to a regular file
+    if(checkpointName != NULL && filter &&
+            (compression != NO_COMPRESSION || ftello(stdout) < 0)){
+        fprintf(stderr, "Checkpoints need uncompressed output to a file -- exiting!\n");
+        return EXIT_FAILURE;
+    }
     
     /*=========== process graphs ===========*/
     GRAPH graph;
     ADJACENCY adj;
     bitset *neighbours = (bitset *)malloc(sizeof(bitset)*MAXN);
-    unsigned long long numberOfGraphs = 0ULL;
-    unsigned long long numberOfHamiltonianConnected = 0ULL;
-    unsigned long long numberOfNotHamiltonianConnected = 0ULL;
     unsigned short code[MAXCODELENGTH];
     int length;
-    if(filter){
-        writePlanarCodeHeader(stdout);
+    FILE *input = openInputStream(stdin);
+    FILE *output = NULL;
+    if(resume){
+        SUMMARY checkpoint;
+        if(!readCheckpoint(checkpointName, &checkpoint)){
+            fprintf(stderr, "Could not read checkpoint %s -- exiting!\n", checkpointName);
+            return EXIT_FAILURE;
+        }
+        if(getSummaryValue(&checkpoint, "residue") != residue ||
+                getSummaryValue(&checkpoint, "modulus") != modulus){
+            fprintf(stderr, "The checkpoint belongs to another part -- exiting!\n");
+            return EXIT_FAILURE;
+        }
+        if(filter != (getSummaryValue(&checkpoint, "output_length") != 0)){
+            fprintf(stderr, "The checkpoint was written with other outputs -- exiting!\n");
+            return EXIT_FAILURE;
+        }
+        restoreCounters(&checkpoint);
+        skipGraphs(input, graphIndex, getSummaryValue(&checkpoint, "input_offset"));
+        if(filter){
+            output = stdout;
+            truncateStream(output, getSummaryValue(&checkpoint, "output_length"));
+        }
+    } else if(filter){
+        output = openOutputStream(stdout, compression);
+        writePlanarCodeHeader(output);
     }
-    while (readPlanarCode(code, &length, stdin)) {
+    time_t lastCheckpoint = time(NULL);
+    while (readPlanarCode(code, &length, input)) {
+        if((graphIndex++) % modulus != residue){
+            continue;
+        }
         decodePlanarCode(code, graph, adj, neighbours);
-        if(isHamiltonianConnected(graph, adj, neighbours)){
+        if(benchLabel != NULL){
+            searchNodes = 0ULL;
+            startTiming();
+        }
+        boolean hamiltonianConnected;
+        boolean prefiltered = prefilter && violatesScatteringCondition(graph,
+                adj, neighbours, &failingStart, &failingEnd);
+        if(prefiltered){
+            hamiltonianConnected = FALSE;
+            numberOfPrefiltered++;
+        } else {
+            hamiltonianConnected = isHamiltonianConnected(graph, adj, neighbours);
+        }
+        if(benchLabel != NULL){
+            stopTiming(code[0], searchNodes);
+        }
+        if(crossCheckFraction > 0.0 && sampleForCrossCheck(crossCheckFraction)){
+            crossCheck(graph, adj, graphIndex, hamiltonianConnected,
+                    prefiltered ? NULL : connected, failingStart, failingEnd);
+            numberOfCrossChecked++;
+        }
+        if(hamiltonianConnected){
             numberOfHamiltonianConnected++;
             if(filter && !invert){
-                writeCode(stdout, code, length);
+                writeCode(output, code, length);
+                numberOfWritten++;
             }
         } else {
             numberOfNotHamiltonianConnected++;
+            if(verbose){
+                fprintf(stderr, "Graph %llu: no hamiltonian path between %d and %d.\n",
+                        graphIndex, failingStart, failingEnd);
+            }
             if(filter && invert){
-                writeCode(stdout, code, length);
+                writeCode(output, code, length);
+                numberOfWritten++;
             }
         }
         numberOfGraphs++;
+        if(checkpointName != NULL && time(NULL) - lastCheckpoint >= checkpointInterval){
+            saveCheckpoint(checkpointName, input, output);
+            lastCheckpoint = time(NULL);
+        }
+    }
+    if(checkpointName != NULL){
+        saveCheckpoint(checkpointName, input, output);
     }
     
     fprintf(stderr, "Read %llu graph%s.\n", numberOfGraphs, 
@@ -329,7 +584,41 @@ int main(int argc, char *argv[]) {
                 numberOfNotHamiltonianConnected, 
                 numberOfNotHamiltonianConnected==1 ? "" : "s", 
                 numberOfNotHamiltonianConnected==1 ? "was" : "were");
+    if(prefilter){
+        fprintf(stderr, "   %llu graph%s %s rejected by the prefilter.\n",
+                numberOfPrefiltered,
+                numberOfPrefiltered==1 ? "" : "s",
+                numberOfPrefiltered==1 ? "was" : "were");
+    }
+    if(crossCheckFraction > 0.0){
+        fprintf(stderr, "   %llu graph%s %s cross-checked.\n",
+                numberOfCrossChecked,
+                numberOfCrossChecked==1 ? "" : "s",
+                numberOfCrossChecked==1 ? "was" : "were");
+    }
     
+    if(output != NULL){
+        fclose(output);
+    }
+    
+    if(summaryName != NULL){
+        FILE *summaryFile = fopen(summaryName, "w");
+        if(summaryFile == NULL){
+            fprintf(stderr, "Could not open %s -- exiting!\n", summaryName);
+            return EXIT_FAILURE;
+        }
+        SUMMARY summary;
+        storeCounters(&summary);
+        writeSummary(summaryFile, &summary);
+        fclose(summaryFile);
+    }
+    
+    if(benchLabel != NULL){
+        writeBenchmarkReport(stderr, benchLabel, benchBaseline);
+        if(benchOutput != NULL){
+            appendBenchmarkRecords(benchOutput, benchLabel);
+        }
+    }
 
     return EXIT_SUCCESS;
 }
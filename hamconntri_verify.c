@@ -0,0 +1,311 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Verifies the certificates written by hamconntri. Each witness path is
+ * checked to be a hamiltonian path. From each witness path we derive the
+ * pairs that are connected by rotating the path once or twice (Posa
+ * rotations), and by the hamiltonian cycle if the endpoints are adjacent.
+ * Every rotated path is constructed explicitly, so we do not rely on the
+ * derivations of hamconntri.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <getopt.h>
+#include "bitset.h"
+#include "lw_plane_graph.h"
+#include "boolean.h"
+#include "certificate.h"
+#include "compression.h"
+
+bitset connected[MAXN+1];
+
+void addConnectedPair(int v1, int v2){
+    ADD(connected[v1], v2);
+    ADD(connected[v2], v1);
+}
+
+/**
+ * Checks that the path visits every vertex once and that consecutive
+ * vertices are adjacent.
+ */
+boolean isHamiltonianPath(bitset *neighbours, unsigned char *path, int order){
+    int i;
+    bitset visited = EMPTY_SET;
+
+    for(i = 0; i < order; i++){
+        if(path[i] < 1 || path[i] > order || CONTAINS(visited, path[i])){
+            return FALSE;
+        }
+        ADD(visited, path[i]);
+        if(i && !CONTAINS(neighbours[path[i]], path[i-1])){
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * Reverses the part of the path between the positions from and to.
+ */
+void reverseSegment(int *path, int from, int to){
+    while(from < to){
+        int temp = path[from];
+        path[from] = path[to];
+        path[to] = temp;
+        from++;
+        to--;
+    }
+}
+
+/**
+ * Adds the pairs that are connected by the path, by the hamiltonian cycle if
+ * the endpoints are adjacent, and by a single rotation at either end.
+ */
+void deriveDirectPairs(GRAPH graph, ADJACENCY adj, bitset *neighbours,
+        int *path, int order){
+    int i;
+    int position[MAXN+1];
+    int start = path[0];
+    int end = path[order-1];
+
+    for(i = 0; i < order; i++){
+        position[path[i]] = i;
+    }
+
+    addConnectedPair(start, end);
+
+    if(CONTAINS(neighbours[start], end)){
+        for(i = 1; i < order; i++){
+            addConnectedPair(path[i-1], path[i]);
+        }
+    }
+
+    //the edge from start to path[p] gives a path from path[p-1] to end
+    for(i = 0; i < adj[start]; i++){
+        int p = position[graph[start][i]];
+        if(p > 1){
+            addConnectedPair(path[p-1], end);
+        }
+    }
+
+    //the edge from end to path[p] gives a path from start to path[p+1]
+    for(i = 0; i < adj[end]; i++){
+        int p = position[graph[end][i]];
+        if(p < order - 2){
+            addConnectedPair(start, path[p+1]);
+        }
+    }
+}
+
+void deriveConnectedPairs(GRAPH graph, ADJACENCY adj, bitset *neighbours,
+        unsigned char *witness, int order){
+    int i, j;
+    int path[MAXN];
+    int position[MAXN+1];
+    int rotated[MAXN];
+
+    for(i = 0; i < order; i++){
+        path[i] = witness[i];
+        position[path[i]] = i;
+    }
+    int start = path[0];
+    int end = path[order-1];
+
+    deriveDirectPairs(graph, adj, neighbours, path, order);
+
+    for(i = 0; i < adj[start]; i++){
+        int p = position[graph[start][i]];
+        if(p > 1){
+            for(j = 0; j < order; j++){
+                rotated[j] = path[j];
+            }
+            reverseSegment(rotated, 0, p - 1);
+            deriveDirectPairs(graph, adj, neighbours, rotated, order);
+        }
+    }
+
+    for(i = 0; i < adj[end]; i++){
+        int p = position[graph[end][i]];
+        if(p < order - 2){
+            for(j = 0; j < order; j++){
+                rotated[j] = path[j];
+            }
+            reverseSegment(rotated, p + 1, order - 1);
+            deriveDirectPairs(graph, adj, neighbours, rotated, order);
+        }
+    }
+}
+
+/**
+ *
+ * @return returns TRUE if the witness paths prove that the graph is
+ * hamiltonian-connected. Otherwise start and end are set to a pair of
+ * vertices that is not covered (or to 0 if a witness is invalid).
+ */
+boolean verifyCertificate(GRAPH graph, ADJACENCY adj, bitset *neighbours,
+        WITNESSES paths, int pathCount, int *start, int *end){
+    int i, j;
+    int order = graph[0][0];
+
+    for(i = 1; i <= order; i++){
+        connected[i] = EMPTY_SET;
+    }
+
+    for(i = 0; i < pathCount; i++){
+        if(!isHamiltonianPath(neighbours, paths[i], order)){
+            *start = *end = 0;
+            return FALSE;
+        }
+        deriveConnectedPairs(graph, adj, neighbours, paths[i], order);
+    }
+
+    for(i = 1; i < order; i++){
+        for(j = i + 1; j <= order; j++){
+            if(!CONTAINS(connected[i], j)){
+                *start = i;
+                *end = j;
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+ //====================== USAGE =======================
+
+void help(char *name) {
+    fprintf(stderr, "The program %s verifies the certificates that were written by\nhamconntri for the plane triangulations that are read from standard in.\n\n", name);
+    fprintf(stderr, "Usage\n=====\n");
+    fprintf(stderr, " %s [options] certificate\n\n", name);
+    fprintf(stderr, "Valid options\n=============\n");
+    fprintf(stderr, "    -v, --verbose\n");
+    fprintf(stderr, "       Print the reason for each rejected certificate.\n");
+    fprintf(stderr, "    -m, --part res/mod\n");
+    fprintf(stderr, "       The certificate was written for the part res/mod of the input.\n");
+    fprintf(stderr, "    -h, --help\n");
+    fprintf(stderr, "       Print this help and return.\n");
+}
+
+void usage(char *name) {
+    fprintf(stderr, "Usage: %s [options] certificate\n", name);
+    fprintf(stderr, "For more information type: %s -h \n\n", name);
+}
+
+int main(int argc, char *argv[]) {
+
+    /*=========== commandline parsing ===========*/
+    boolean verbose = FALSE;
+    unsigned long long residue = 0ULL;
+    unsigned long long modulus = 1ULL;
+    int c;
+    char *name = argv[0];
+    static struct option long_options[] = {
+        {"verbose", no_argument, NULL, 'v'},
+        {"part", required_argument, NULL, 'm'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+    int option_index = 0;
+
+    while ((c = getopt_long(argc, argv, "hvm:", long_options, &option_index)) != -1) {
+        switch (c) {
+            case 'v':
+                verbose = TRUE;
+                break;
+            case 'm':
+                if(sscanf(optarg, "%llu/%llu", &residue, &modulus) != 2 ||
+                        residue >= modulus){
+                    fprintf(stderr, "Illegal part %s.\n", optarg);
+                    usage(name);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'h':
+                help(name);
+                return EXIT_SUCCESS;
+            case '?':
+                usage(name);
+                return EXIT_FAILURE;
+            default:
+                fprintf(stderr, "Illegal option %c.\n", c);
+                usage(name);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if(argc - optind != 1){
+        usage(name);
+        return EXIT_FAILURE;
+    }
+
+    FILE *certificateFile = fopen(argv[optind], "rb");
+    if(certificateFile == NULL || !readCertificateHeader(certificateFile)){
+        fprintf(stderr, "Could not read certificate %s -- exiting!\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    /*=========== verify certificates ===========*/
+    GRAPH graph;
+    ADJACENCY adj;
+    bitset neighbours[MAXN+1];
+    static WITNESSES paths;
+    int pathCount;
+    unsigned long long numberOfGraphs = 0ULL;
+    unsigned long long graphIndex = 0ULL;
+    unsigned long long numberOfVerified = 0ULL;
+    unsigned long long numberOfRejected = 0ULL;
+    unsigned long long numberOfUncertified = 0ULL;
+    unsigned short code[MAXCODELENGTH];
+    int length;
+    FILE *input = openInputStream(stdin);
+    while (readPlanarCode(code, &length, input)) {
+        if((graphIndex++) % modulus != residue){
+            continue;
+        }
+        decodePlanarCode(code, graph, adj, neighbours);
+        numberOfGraphs++;
+        if(!readCertificate(certificateFile, paths, &pathCount, code[0])){
+            fprintf(stderr, "Certificate ends before graph %llu -- exiting!\n", numberOfGraphs);
+            return EXIT_FAILURE;
+        }
+        if(!pathCount){
+            numberOfUncertified++;
+            continue;
+        }
+        int start, end;
+        if(verifyCertificate(graph, adj, neighbours, paths, pathCount, &start, &end)){
+            numberOfVerified++;
+        } else {
+            numberOfRejected++;
+            if(verbose && start){
+                fprintf(stderr, "Graph %llu: no witness for %d and %d.\n",
+                        graphIndex, start, end);
+            } else if(verbose){
+                fprintf(stderr, "Graph %llu: invalid witness path.\n", graphIndex);
+            }
+        }
+    }
+
+    fprintf(stderr, "Read %llu graph%s.\n", numberOfGraphs,
+                numberOfGraphs==1 ? "" : "s");
+    fprintf(stderr, "   %llu certificate%s %s verified.\n",
+                numberOfVerified,
+                numberOfVerified==1 ? "" : "s",
+                numberOfVerified==1 ? "was" : "were");
+    fprintf(stderr, "   %llu certificate%s %s rejected.\n",
+                numberOfRejected,
+                numberOfRejected==1 ? "" : "s",
+                numberOfRejected==1 ? "was" : "were");
+    fprintf(stderr, "   %llu graph%s had no witness paths.\n",
+                numberOfUncertified,
+                numberOfUncertified==1 ? "" : "s");
+
+    return numberOfRejected ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* The iterative search kernel. This file is included once without
+ * KERNEL_ORDER, which gives the generic kernel startIterativePath, and once
+ * for each order in specialised_kernels.h with KERNEL_ORDER defined, which
+ * gives a kernel startIterativePath_<order> in which the order is a
+ * compile-time constant. The including file has to provide currentPath,
+ * pathSequence, pathPosition, pathLength, searchNodes and completePath.
+ */
+
+#ifdef KERNEL_ORDER
+#define KERNEL_NAME(order) KERNEL_NAME_(order)
+#define KERNEL_NAME_(order) startIterativePath_ ## order
+#define KERNEL_SIZE KERNEL_ORDER
+#define KERNEL_PATH_ORDER KERNEL_ORDER
+#else
+#define KERNEL_SIZE MAXN
+#define KERNEL_PATH_ORDER order
+#endif
+
+/**
+ * Searches a hamiltonian path from startVertex to targetVertex without
+ * recursion. The path itself is the stack: for each vertex on the path we
+ * store the neighbours that still need to be tried. The result is the same
+ * as for startPath.
+ */
+#ifdef KERNEL_ORDER
+boolean KERNEL_NAME(KERNEL_ORDER)(GRAPH graph, ADJACENCY adj, bitset *neighbours, int startVertex, int targetVertex, int order){
+#else
+boolean startIterativePath(GRAPH graph, ADJACENCY adj, bitset *neighbours, int startVertex, int targetVertex, int order){
+#endif
+    bitset remainingNeighbours[KERNEL_SIZE];
+    bitset targetNeighbours = neighbours[targetVertex];
+    bitset targetSet = SINGLETON(targetVertex);
+
+    int unvisitedNeighboursOfTarget = adj[targetVertex];
+    if(CONTAINS(targetNeighbours, startVertex)){
+        unvisitedNeighboursOfTarget--;
+    }
+
+    currentPath = SINGLETON(startVertex);
+    pathSequence[0] = startVertex;
+    pathPosition[startVertex] = 0;
+    pathLength = 1;
+    remainingNeighbours[0] = neighbours[startVertex] & ~targetSet;
+
+    while(pathLength){
+        int top = pathLength - 1;
+
+        if(IS_EMPTY(remainingNeighbours[top])){
+            //backtrack
+            int last = pathSequence[top];
+            if(!top){
+                break;
+            }
+            REMOVE(currentPath, last);
+            if(CONTAINS(targetNeighbours, last)){
+                unvisitedNeighboursOfTarget++;
+            }
+            pathLength--;
+            continue;
+        }
+
+        int next = FIRST_ELEMENT(remainingNeighbours[top]);
+        REMOVE(remainingNeighbours[top], next);
+
+        searchNodes++;
+        ADD(currentPath, next);
+        pathSequence[pathLength] = next;
+        pathPosition[next] = pathLength;
+        pathLength++;
+        if(CONTAINS(targetNeighbours, next)){
+            unvisitedNeighboursOfTarget--;
+        }
+
+        if(pathLength == KERNEL_PATH_ORDER - 1){
+            if(CONTAINS(targetNeighbours, next)){
+                pathSequence[pathLength] = targetVertex;
+                pathPosition[targetVertex] = pathLength;
+                pathLength++;
+                if(completePath(graph, adj, neighbours)){
+                    return TRUE;
+                }
+                pathLength--;
+            }
+            remainingNeighbours[pathLength - 1] = EMPTY_SET;
+        } else if(!unvisitedNeighboursOfTarget){
+            //the target vertex is no longer reachable
+            remainingNeighbours[pathLength - 1] = EMPTY_SET;
+        } else {
+            remainingNeighbours[pathLength - 1] =
+                    neighbours[next] & ~(currentPath | targetSet);
+        }
+    }
+
+    return FALSE;
+}
+
+#undef KERNEL_SIZE
+#undef KERNEL_PATH_ORDER
+#ifdef KERNEL_ORDER
+#undef KERNEL_NAME
+#undef KERNEL_NAME_
+#undef KERNEL_ORDER
+#endif
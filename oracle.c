@@ -0,0 +1,97 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* A brute-force reference for the search engines.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "oracle.h"
+
+unsigned long long crossCheckState = 1ULL;
+
+/**
+ * Tries every extension of the path that ends in last. The visited vertices
+ * include last, and remaining is the number of vertices that are not visited.
+ */
+boolean oracleExtendPath(GRAPH graph, ADJACENCY adj, bitset visited,
+        int last, int end, int remaining){
+    int i;
+
+    if(last == end){
+        return remaining == 0;
+    }
+    for(i = 0; i < adj[last]; i++){
+        int next = graph[last][i];
+        if(!CONTAINS(visited, next) &&
+                oracleExtendPath(graph, adj, visited | SINGLETON(next), next, end, remaining - 1)){
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+boolean oracleHasHamiltonianPath(GRAPH graph, ADJACENCY adj, int start, int end){
+    return oracleExtendPath(graph, adj, SINGLETON(start), start, end, graph[0][0] - 1);
+}
+
+void seedCrossCheck(unsigned long long seed){
+    //xorshift64* needs a non-zero state
+    crossCheckState = seed ? seed : 1ULL;
+}
+
+boolean sampleForCrossCheck(double fraction){
+    crossCheckState ^= crossCheckState >> 12;
+    crossCheckState ^= crossCheckState << 25;
+    crossCheckState ^= crossCheckState >> 27;
+    unsigned long long r = crossCheckState * 2685821657736338717ULL;
+    return (r >> 11) * (1.0 / 9007199254740992.0) < fraction;
+}
+
+void reportDisagreement(GRAPH graph, ADJACENCY adj, unsigned long long graphIndex,
+        int v1, int v2, boolean engineClaim){
+    int i, j;
+
+    fprintf(stderr, "Graph %llu: the engine claims that %d and %d are %sconnected by a hamiltonian path, but the oracle disagrees.\n",
+            graphIndex, v1, v2, engineClaim ? "" : "not ");
+    for(i = 1; i <= graph[0][0]; i++){
+        fprintf(stderr, "%3d:", i);
+        for(j = 0; j < adj[i]; j++){
+            fprintf(stderr, " %d", graph[i][j]);
+        }
+        fprintf(stderr, "\n");
+    }
+    fprintf(stderr, "Cross-check failed -- exiting!\n");
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Checks every claim of the engine for this graph with the oracle. If the
+ * graph is hamiltonian-connected, every pair is claimed to be connected.
+ * Otherwise the failing pair is claimed not to be connected, and the pairs in
+ * claimed (if not NULL) are claimed to be connected. The program exits at the
+ * first disagreement.
+ */
+void crossCheck(GRAPH graph, ADJACENCY adj, unsigned long long graphIndex,
+        boolean hamiltonianConnected, bitset *claimed, int failingStart, int failingEnd){
+    int i, j;
+    int order = graph[0][0];
+
+    if(!hamiltonianConnected &&
+            oracleHasHamiltonianPath(graph, adj, failingStart, failingEnd)){
+        reportDisagreement(graph, adj, graphIndex, failingStart, failingEnd, FALSE);
+    }
+    for(i = 1; i < order; i++){
+        for(j = i + 1; j <= order; j++){
+            if((hamiltonianConnected || (claimed != NULL && CONTAINS(claimed[i], j))) &&
+                    !oracleHasHamiltonianPath(graph, adj, i, j)){
+                reportDisagreement(graph, adj, graphIndex, i, j, TRUE);
+            }
+        }
+    }
+}
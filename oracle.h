@@ -0,0 +1,30 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* A brute-force reference for the search engines. Each pair of vertices is
+ * checked independently by an exhaustive search without derivations or
+ * pruning. This is slow, so it is meant to be run on a sample of the graphs.
+ */
+
+#include "bitset.h"
+#include "boolean.h"
+#include "lw_plane_graph.h"
+
+#ifndef ORACLE_H
+#define	ORACLE_H
+
+boolean oracleHasHamiltonianPath(GRAPH graph, ADJACENCY adj, int start, int end);
+
+void seedCrossCheck(unsigned long long seed);
+
+boolean sampleForCrossCheck(double fraction);
+
+void crossCheck(GRAPH graph, ADJACENCY adj, unsigned long long graphIndex,
+        boolean hamiltonianConnected, bitset *claimed, int failingStart, int failingEnd);
+
+#endif	/* ORACLE_H */
+
@@ -0,0 +1,128 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Cheap necessary conditions for hamiltonian-connectedness.
+ *
+ * If a hamiltonian path between u and v exists and S is a set of vertices
+ * that contains both u and v, then removing S from the path leaves at most
+ * |S|-1 pieces. So if G-S has at least |S| components, then no two vertices
+ * of S are connected by a hamiltonian path. We check this condition for
+ * the neighbourhoods of some independent sets. For kleetopes and other
+ * graphs with many independent vertices of degree 3 this detects the
+ * failure immediately.
+ */
+
+#include "prefilter.h"
+
+int countComponentsWithout(GRAPH graph, ADJACENCY adj, bitset *neighbours, bitset removed){
+    int i, v;
+    int order = graph[0][0];
+    int components = 0;
+    bitset visited = removed;
+
+    for(v = 1; v <= order; v++){
+        if(CONTAINS(visited, v)){
+            continue;
+        }
+        components++;
+        //grow the component of v until it no longer changes
+        bitset component = SINGLETON(v);
+        bitset previous = EMPTY_SET;
+        while(component != previous){
+            previous = component;
+            for(i = 1; i <= order; i++){
+                if(CONTAINS(previous, i)){
+                    ADD_ALL(component, neighbours[i]);
+                }
+            }
+            component &= ~removed;
+        }
+        ADD_ALL(visited, component);
+    }
+
+    return components;
+}
+
+int countElements(bitset set){
+    int count = 0;
+    while(set){
+        set &= set - 1;
+        count++;
+    }
+    return count;
+}
+
+boolean checkIndependentSet(GRAPH graph, ADJACENCY adj, bitset *neighbours,
+        bitset independentSet, int *start, int *end){
+    int v;
+    int order = graph[0][0];
+    bitset separator = EMPTY_SET;
+
+    for(v = 1; v <= order; v++){
+        if(CONTAINS(independentSet, v)){
+            ADD_ALL(separator, neighbours[v]);
+        }
+    }
+
+    if(countElements(separator) < 2 ||
+            countComponentsWithout(graph, adj, neighbours, separator) < countElements(separator)){
+        return FALSE;
+    }
+
+    //any two vertices of the separator will do
+    *start = *end = 0;
+    for(v = 1; v <= order; v++){
+        if(CONTAINS(separator, v)){
+            if(*start){
+                *end = v;
+                break;
+            }
+            *start = v;
+        }
+    }
+    return TRUE;
+}
+
+/**
+ * Checks some cheap necessary conditions for hamiltonian-connectedness.
+ * 
+ * @return returns TRUE if the graph is certainly not hamiltonian-connected.
+ * In that case start and end are set to two vertices that are not connected
+ * by a hamiltonian path.
+ */
+boolean violatesScatteringCondition(GRAPH graph, ADJACENCY adj, bitset *neighbours,
+        int *start, int *end){
+    int i, v;
+    int order = graph[0][0];
+
+    //the vertices of degree 3 (these are independent in a triangulation on
+    //more than 4 vertices)
+    bitset independentSet = EMPTY_SET;
+    for(v = 1; v <= order; v++){
+        if(adj[v] == 3){
+            ADD(independentSet, v);
+        }
+    }
+    if(order > 4 && checkIndependentSet(graph, adj, neighbours,
+            independentSet, start, end)){
+        return TRUE;
+    }
+
+    //a greedy independent set that prefers vertices with a small degree
+    bitset forbidden = EMPTY_SET;
+    independentSet = EMPTY_SET;
+    for(i = 3; i < order; i++){
+        for(v = 1; v <= order; v++){
+            if(adj[v] == i && !CONTAINS(forbidden, v)){
+                ADD(independentSet, v);
+                ADD(forbidden, v);
+                ADD_ALL(forbidden, neighbours[v]);
+            }
+        }
+    }
+    return checkIndependentSet(graph, adj, neighbours, independentSet, start, end);
+}
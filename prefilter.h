@@ -0,0 +1,22 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Cheap necessary conditions for hamiltonian-connectedness.
+ */
+
+#include "bitset.h"
+#include "boolean.h"
+#include "lw_plane_graph.h"
+
+#ifndef PREFILTER_H
+#define	PREFILTER_H
+
+boolean violatesScatteringCondition(GRAPH graph, ADJACENCY adj, bitset *neighbours,
+        int *start, int *end);
+
+#endif	/* PREFILTER_H */
+
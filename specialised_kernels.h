@@ -0,0 +1,88 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* The iterative search kernel specialised for the orders 4 to 24, which
+ * covers the orders of exhaustive runs and of the graphs that remain after
+ * removing the vertices of degree 3. The table specialisedKernels contains
+ * the kernel for each order, or NULL if the generic kernel has to be used.
+ */
+
+#ifndef SPECIALISED_KERNELS_H
+#define	SPECIALISED_KERNELS_H
+
+#define KERNEL_ORDER 4
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 5
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 6
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 7
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 8
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 9
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 10
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 11
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 12
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 13
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 14
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 15
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 16
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 17
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 18
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 19
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 20
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 21
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 22
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 23
+#include "iterative_kernel.h"
+#define KERNEL_ORDER 24
+#include "iterative_kernel.h"
+
+typedef boolean (*KERNEL)(GRAPH graph, ADJACENCY adj, bitset *neighbours,
+        int startVertex, int targetVertex, int order);
+
+KERNEL specialisedKernels[MAXN + 1] = {
+    [4] = startIterativePath_4,
+    [5] = startIterativePath_5,
+    [6] = startIterativePath_6,
+    [7] = startIterativePath_7,
+    [8] = startIterativePath_8,
+    [9] = startIterativePath_9,
+    [10] = startIterativePath_10,
+    [11] = startIterativePath_11,
+    [12] = startIterativePath_12,
+    [13] = startIterativePath_13,
+    [14] = startIterativePath_14,
+    [15] = startIterativePath_15,
+    [16] = startIterativePath_16,
+    [17] = startIterativePath_17,
+    [18] = startIterativePath_18,
+    [19] = startIterativePath_19,
+    [20] = startIterativePath_20,
+    [21] = startIterativePath_21,
+    [22] = startIterativePath_22,
+    [23] = startIterativePath_23,
+    [24] = startIterativePath_24
+};
+
+#endif	/* SPECIALISED_KERNELS_H */
+
@@ -0,0 +1,78 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Machine-readable summaries of a run.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "summary.h"
+
+void clearSummary(SUMMARY *summary){
+    summary->size = 0;
+}
+
+void setSummaryValue(SUMMARY *summary, char *key, unsigned long long value){
+    int i;
+    for(i = 0; i < summary->size; i++){
+        if(strcmp(summary->keys[i], key) == 0){
+            summary->values[i] = value;
+            return;
+        }
+    }
+    if(summary->size == MAXSUMMARYENTRIES){
+        fprintf(stderr, "Too many summary entries -- exiting!\n");
+        exit(EXIT_FAILURE);
+    }
+    snprintf(summary->keys[summary->size], MAXKEYLENGTH, "%s", key);
+    summary->values[summary->size] = value;
+    summary->size++;
+}
+
+/**
+ * 
+ * @return returns the value for the key, or 0 if the key is not present.
+ */
+unsigned long long getSummaryValue(SUMMARY *summary, char *key){
+    int i;
+    for(i = 0; i < summary->size; i++){
+        if(strcmp(summary->keys[i], key) == 0){
+            return summary->values[i];
+        }
+    }
+    return 0ULL;
+}
+
+void writeSummary(FILE *f, SUMMARY *summary){
+    int i;
+    for(i = 0; i < summary->size; i++){
+        fprintf(f, "%s=%llu\n", summary->keys[i], summary->values[i]);
+    }
+}
+
+/**
+ * 
+ * @return returns 1 if the summary was read and 0 in case of a malformed line.
+ */
+int readSummary(FILE *f, SUMMARY *summary){
+    char line[2*MAXKEYLENGTH];
+    char key[MAXKEYLENGTH];
+    unsigned long long value;
+    
+    clearSummary(summary);
+    while(fgets(line, sizeof(line), f) != NULL){
+        if(line[0] == '\n'){
+            continue;
+        }
+        if(sscanf(line, "%63[^=]=%llu", key, &value) != 2){
+            return 0;
+        }
+        setSummaryValue(summary, key, value);
+    }
+    return 1;
+}
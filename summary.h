@@ -0,0 +1,38 @@
+/*
+ * Main developer: Nico Van Cleemput
+ *
+ * Copyright (C) 2015 Nico Van Cleemput.
+ * Licensed under the GNU AFFERO GPL, read the file LICENSE for details.
+ */
+
+/* Machine-readable summaries of a run. A summary is a list of lines of the
+ * form key=value with non-negative integer values. The keys residue and
+ * modulus describe which part of the input was processed.
+ */
+
+#include <stdio.h>
+
+#ifndef SUMMARY_H
+#define	SUMMARY_H
+
+#define MAXSUMMARYENTRIES 32
+#define MAXKEYLENGTH 64
+
+typedef struct {
+    int size;
+    char keys[MAXSUMMARYENTRIES][MAXKEYLENGTH];
+    unsigned long long values[MAXSUMMARYENTRIES];
+} SUMMARY;
+
+void clearSummary(SUMMARY *summary);
+
+void setSummaryValue(SUMMARY *summary, char *key, unsigned long long value);
+
+unsigned long long getSummaryValue(SUMMARY *summary, char *key);
+
+void writeSummary(FILE *f, SUMMARY *summary);
+
+int readSummary(FILE *f, SUMMARY *summary);
+
+#endif	/* SUMMARY_H */
+